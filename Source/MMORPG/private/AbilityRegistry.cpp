@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AbilityRegistry.h"
+#include "Engine/Engine.h"
+
+const FName UAbilityRegistry::DefaultMeleeAbility(TEXT("MeleeAttack"));
+const FName UAbilityRegistry::DefaultRangedAbility(TEXT("RangedAttack"));
+const FName UAbilityRegistry::DefaultMagicalAbility(TEXT("MagicalAttack"));
+
+namespace
+{
+	FAttackAbilityData MakeDefaultAbility(const FString& Name, EAttackType AttackType, float Damage, float Range, float Cooldown,
+		EResourceType CostType, float CostAmount)
+	{
+		FAttackAbilityData Ability;
+		Ability.AbilityName = Name;
+		Ability.AttackType = AttackType;
+		Ability.Damage = Damage;
+		Ability.Range = Range;
+		Ability.Cooldown = Cooldown;
+
+		FResourceCost Cost;
+		Cost.ResourceType = CostType;
+		Cost.Amount = CostAmount;
+		Ability.ResourceCosts.Add(Cost);
+		return Ability;
+	}
+}
+
+void UAbilityRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Table rows come first so they take the built-in names; definitions never change once registered
+	if (!AbilityDefinitionTable.IsNull())
+	{
+		LoadDefinitions(AbilityDefinitionTable.LoadSynchronous());
+	}
+
+	RegisterDefaultAbilities();
+}
+
+void UAbilityRegistry::LoadDefinitions(UDataTable* DefinitionTable)
+{
+	if (!DefinitionTable)
+	{
+		return;
+	}
+
+	DefinitionTable->ForeachRow<FAbilityDefinitionRow>(TEXT("UAbilityRegistry::LoadDefinitions"),
+		[this](const FName& RowName, const FAbilityDefinitionRow& Row)
+		{
+			RegisterAbility(RowName, Row.Ability);
+		});
+}
+
+FAbilityHandle UAbilityRegistry::RegisterAbility(FName AbilityName, const FAttackAbilityData& Ability)
+{
+	if (AbilityName.IsNone())
+	{
+		return FAbilityHandle();
+	}
+
+	if (const uint16* ExistingIndex = DefinitionIndexByName.Find(AbilityName))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ability %s is already registered; the new definition was ignored"), *AbilityName.ToString());
+		return FAbilityHandle(*ExistingIndex);
+	}
+
+	if (Definitions.Num() >= FAbilityHandle::InvalidIndex)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Ability registry is full; %s was not registered"), *AbilityName.ToString());
+		return FAbilityHandle();
+	}
+
+	const uint16 Index = static_cast<uint16>(Definitions.Add(Ability));
+	DefinitionIndexByName.Add(AbilityName, Index);
+	return FAbilityHandle(Index);
+}
+
+FAbilityHandle UAbilityRegistry::FindAbility(FName AbilityName) const
+{
+	const uint16* Index = DefinitionIndexByName.Find(AbilityName);
+	return Index ? FAbilityHandle(*Index) : FAbilityHandle();
+}
+
+const FAttackAbilityData* UAbilityRegistry::GetAbility(FAbilityHandle Handle) const
+{
+	return Definitions.IsValidIndex(Handle.GetIndex()) ? &Definitions[Handle.GetIndex()] : nullptr;
+}
+
+UAbilityRegistry* UAbilityRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UAbilityRegistry>() : nullptr;
+}
+
+void UAbilityRegistry::RegisterDefaultAbilities()
+{
+	if (!FindAbility(DefaultMeleeAbility).IsValid())
+	{
+		RegisterAbility(DefaultMeleeAbility,
+			MakeDefaultAbility(TEXT("Melee Attack"), EAttackType::MeleeAttack, 15.0f, 150.0f, 1.0f, EResourceType::Stamina, 10.0f));
+	}
+	if (!FindAbility(DefaultRangedAbility).IsValid())
+	{
+		RegisterAbility(DefaultRangedAbility,
+			MakeDefaultAbility(TEXT("Ranged Attack"), EAttackType::RangedAttack, 20.0f, 500.0f, 1.5f, EResourceType::Stamina, 15.0f));
+	}
+	if (!FindAbility(DefaultMagicalAbility).IsValid())
+	{
+		RegisterAbility(DefaultMagicalAbility,
+			MakeDefaultAbility(TEXT("Magical Attack"), EAttackType::MagicalAttack, 30.0f, 400.0f, 2.0f, EResourceType::Mana, 25.0f));
+	}
+}
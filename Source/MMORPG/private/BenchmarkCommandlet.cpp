@@ -0,0 +1,334 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BenchmarkCommandlet.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include <atomic>
+
+namespace
+{
+	/**
+	 * Forwards to the real allocator and, while enabled, counts what passes through
+	 * Installed as GMalloc for the length of a benchmark run
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		void Begin()
+		{
+			Allocations = 0;
+			BytesAllocated = 0;
+			LiveBytes = 0;
+			PeakLiveBytes = 0;
+			bCounting = true;
+		}
+
+		void End()
+		{
+			bCounting = false;
+		}
+
+		int64 GetAllocations() const { return Allocations.load(std::memory_order_relaxed); }
+		int64 GetBytesAllocated() const { return BytesAllocated.load(std::memory_order_relaxed); }
+		int64 GetPeakLiveBytes() const { return PeakLiveBytes.load(std::memory_order_relaxed); }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			void* Result = InnerMalloc->Malloc(Count, Alignment);
+			if (bCounting)
+			{
+				Allocations.fetch_add(1, std::memory_order_relaxed);
+				BytesAllocated.fetch_add(static_cast<int64>(Count), std::memory_order_relaxed);
+				AddLiveBytes(GetSize(Result, Count));
+			}
+			return Result;
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			const int64 OldSize = bCounting && Original ? GetSize(Original, 0) : 0;
+			void* Result = InnerMalloc->Realloc(Original, Count, Alignment);
+			if (bCounting)
+			{
+				if (Count > 0)
+				{
+					Allocations.fetch_add(1, std::memory_order_relaxed);
+					BytesAllocated.fetch_add(static_cast<int64>(Count), std::memory_order_relaxed);
+				}
+				AddLiveBytes((Result ? GetSize(Result, Count) : 0) - OldSize);
+			}
+			return Result;
+		}
+
+		virtual void Free(void* Original) override
+		{
+			if (bCounting && Original)
+			{
+				AddLiveBytes(-GetSize(Original, 0));
+			}
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("BenchmarkCountingMalloc"); }
+
+		FMalloc* GetInnerMalloc() const { return InnerMalloc; }
+
+	private:
+		// Freed blocks only report a size if the allocator tracks it; otherwise the peak overestimates
+		int64 GetSize(void* Pointer, SIZE_T Fallback) const
+		{
+			SIZE_T Size = 0;
+			return InnerMalloc->GetAllocationSize(Pointer, Size) ? static_cast<int64>(Size) : static_cast<int64>(Fallback);
+		}
+
+		void AddLiveBytes(int64 Delta)
+		{
+			// Raise the peak only if no other thread has already raised it past this value
+			const int64 NewLiveBytes = LiveBytes.fetch_add(Delta, std::memory_order_relaxed) + Delta;
+			int64 Peak = PeakLiveBytes.load(std::memory_order_relaxed);
+			while (NewLiveBytes > Peak && !PeakLiveBytes.compare_exchange_weak(Peak, NewLiveBytes, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		FMalloc* InnerMalloc;
+
+		// Allocations from the task graph, GC and async loading are counted too, so every counter is atomic
+		std::atomic<bool> bCounting { false };
+		std::atomic<int64> Allocations { 0 };
+		std::atomic<int64> BytesAllocated { 0 };
+		std::atomic<int64> LiveBytes { 0 };
+		std::atomic<int64> PeakLiveBytes { 0 };
+	};
+
+	FCountingMalloc* ActiveCountingMalloc = nullptr;
+
+	// Nearest-rank percentile of already sorted samples
+	double GetPercentile(const TArray<double>& SortedSamples, double Percentile)
+	{
+		if (SortedSamples.Num() == 0)
+		{
+			return 0.0;
+		}
+		const int32 Rank = FMath::CeilToInt32(Percentile / 100.0 * SortedSamples.Num());
+		return SortedSamples[FMath::Clamp(Rank - 1, 0, SortedSamples.Num() - 1)];
+	}
+}
+
+UBenchmarkCommandlet::UBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UBenchmarkCommandlet::Main(const FString& Params)
+{
+	FParse::Value(*Params, TEXT("iterations="), Iterations);
+	Iterations = FMath::Max(1, Iterations);
+
+	int32 Seed = 1337;
+	FParse::Value(*Params, TEXT("seed="), Seed);
+	Random.Initialize(Seed);
+
+	FString CsvPath;
+	if (!FParse::Value(*Params, TEXT("csv="), CsvPath))
+	{
+		CsvPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), GetDefaultCsvName());
+	}
+
+	ParseParams(Params);
+
+	FCountingMalloc CountingMalloc(GMalloc);
+	ActiveCountingMalloc = &CountingMalloc;
+	GMalloc = &CountingMalloc;
+
+	Results.Reset();
+	RunScenarios();
+
+	GMalloc = CountingMalloc.GetInnerMalloc();
+	ActiveCountingMalloc = nullptr;
+
+	for (const FBenchmarkResult& Result : Results)
+	{
+		UE_LOG(LogTemp, Display, TEXT("%-24s %10d ops %12.1f ns/op %10.2f allocs/op %12lld peak bytes"),
+			*Result.Scenario, Result.Operations, Result.GetNanosecondsPerOperation(),
+			Result.Operations > 0 ? static_cast<double>(Result.Allocations) / Result.Operations : 0.0,
+			Result.PeakLiveBytes);
+
+		for (const TPair<FString, double>& Metric : Result.Metrics)
+		{
+			UE_LOG(LogTemp, Display, TEXT("    %-20s %14.2f"), *Metric.Key, Metric.Value);
+		}
+	}
+
+	if (!WriteCsv(CsvPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to write benchmark results to %s"), *CsvPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Benchmark results written to %s"), *CsvPath);
+	return 0;
+}
+
+void UBenchmarkCommandlet::RunScenario(const FString& Name, int32 Operations, TFunctionRef<void(int32)> Operation)
+{
+	FBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+	Result.Scenario = Name;
+	Result.Operations = Operations;
+
+	ActiveCountingMalloc->Begin();
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	for (int32 i = 0; i < Operations; ++i)
+	{
+		Operation(i);
+	}
+	const uint64 EndCycles = FPlatformTime::Cycles64();
+	ActiveCountingMalloc->End();
+
+	Result.TotalSeconds = FPlatformTime::ToSeconds64(EndCycles - StartCycles);
+	Result.Allocations = ActiveCountingMalloc->GetAllocations();
+	Result.BytesAllocated = ActiveCountingMalloc->GetBytesAllocated();
+	Result.PeakLiveBytes = ActiveCountingMalloc->GetPeakLiveBytes();
+}
+
+void UBenchmarkCommandlet::RunScenario(const FString& Name, int32 Operations, TFunctionRef<void(int32)> Setup, TFunctionRef<void(int32)> Operation)
+{
+	FBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+	Result.Scenario = Name;
+	Result.Operations = Operations;
+
+	// Sized up front so recording samples never allocates inside a measurement
+	TArray<double> Samples;
+	Samples.Reserve(Operations);
+
+	uint64 MeasuredCycles = 0;
+	for (int32 i = 0; i < Operations; ++i)
+	{
+		Setup(i);
+
+		// Counters restart per operation, so the peak is the largest single operation's
+		ActiveCountingMalloc->Begin();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Operation(i);
+		const uint64 OperationCycles = FPlatformTime::Cycles64() - StartCycles;
+		ActiveCountingMalloc->End();
+
+		MeasuredCycles += OperationCycles;
+		Samples.Add(FPlatformTime::ToSeconds64(OperationCycles) * 1.0e9);
+
+		Result.Allocations += ActiveCountingMalloc->GetAllocations();
+		Result.BytesAllocated += ActiveCountingMalloc->GetBytesAllocated();
+		Result.PeakLiveBytes = FMath::Max(Result.PeakLiveBytes, ActiveCountingMalloc->GetPeakLiveBytes());
+	}
+
+	Result.TotalSeconds = FPlatformTime::ToSeconds64(MeasuredCycles);
+
+	Samples.Sort();
+	Result.P50Nanoseconds = GetPercentile(Samples, 50.0);
+	Result.P95Nanoseconds = GetPercentile(Samples, 95.0);
+	Result.P99Nanoseconds = GetPercentile(Samples, 99.0);
+}
+
+void UBenchmarkCommandlet::AddResultMetric(const FString& Name, double Value)
+{
+	if (Results.Num() > 0)
+	{
+		Results.Last().Metrics.Emplace(Name, Value);
+	}
+}
+
+UWorld* UBenchmarkCommandlet::CreateBenchmarkWorld(const TCHAR* Name)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, Name);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// No game mode is needed; the world settings start play, after which spawned actors begin play at once
+	World->InitializeActorsForPlay(FURL());
+	World->GetWorldSettings()->NotifyBeginPlay();
+	return World;
+}
+
+void UBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+UBenchmarkCommandlet::FScopedFixedTimeStep::FScopedFixedTimeStep(double TickRate, bool bInQuietLog)
+	: bWasUsingFixedTimeStep(FApp::UseFixedTimeStep())
+	, PreviousFixedDeltaTime(FApp::GetFixedDeltaTime())
+	, PreviousLogVerbosity(LogTemp.GetVerbosity())
+	, bQuietLog(bInQuietLog)
+{
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / TickRate);
+	if (bQuietLog)
+	{
+		LogTemp.SetVerbosity(ELogVerbosity::Error);
+	}
+}
+
+UBenchmarkCommandlet::FScopedFixedTimeStep::~FScopedFixedTimeStep()
+{
+	if (bQuietLog)
+	{
+		LogTemp.SetVerbosity(PreviousLogVerbosity);
+	}
+	FApp::SetUseFixedTimeStep(bWasUsingFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+}
+
+bool UBenchmarkCommandlet::WriteCsv(const FString& Path) const
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	FString Csv = TEXT("Scenario,Operations,TotalMs,NsPerOp,Allocations,AllocationsPerOp,BytesAllocated,PeakLiveBytes,ProcessPeakUsedMB,P50Ns,P95Ns,P99Ns,Metrics\n");
+	for (const FBenchmarkResult& Result : Results)
+	{
+		// Extra metrics share one column as Name=Value pairs
+		FString Metrics;
+		for (const TPair<FString, double>& Metric : Result.Metrics)
+		{
+			Metrics += FString::Printf(TEXT("%s%s=%.3f"), Metrics.IsEmpty() ? TEXT("") : TEXT(";"), *Metric.Key, Metric.Value);
+		}
+
+		Csv += FString::Printf(TEXT("%s,%d,%.3f,%.1f,%lld,%.3f,%lld,%lld,%.1f,%.1f,%.1f,%.1f,%s\n"),
+			*Result.Scenario,
+			Result.Operations,
+			Result.TotalSeconds * 1000.0,
+			Result.GetNanosecondsPerOperation(),
+			Result.Allocations,
+			Result.Operations > 0 ? static_cast<double>(Result.Allocations) / Result.Operations : 0.0,
+			Result.BytesAllocated,
+			Result.PeakLiveBytes,
+			MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0),
+			Result.P50Nanoseconds,
+			Result.P95Nanoseconds,
+			Result.P99Nanoseconds,
+			*Metrics);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatAreaBenchmarkCommandlet.h"
+
+namespace
+{
+	constexpr int32 NumCombatants = 5000;
+	constexpr int32 CastsPerSecond = 500;
+	constexpr int32 FramesPerSecond = 30;
+
+	// A 1 km square map, in centimetres
+	constexpr float BattlefieldExtent = 50000.0f;
+	constexpr float MoveStep = 20.0f;
+	constexpr float MinAreaRange = 300.0f;
+	constexpr float MaxAreaRange = 1200.0f;
+}
+
+void UCombatAreaBenchmarkCommandlet::RunScenarios()
+{
+	Positions.SetNumUninitialized(NumCombatants);
+	for (int32 i = 0; i < NumCombatants; ++i)
+	{
+		// Half of the combatants crowd a central fight, the rest are spread over the map
+		const float Extent = i % 2 == 0 ? BattlefieldExtent * 0.1f : BattlefieldExtent;
+		Positions[i] = FVector(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(0.0f, 200.0f));
+	}
+	Grid.Build(Positions);
+	Hits.Reserve(NumCombatants);
+
+	RunScenario(TEXT("GridBuild"), FMath::Max(1, Iterations / 10),
+		[this](int32)
+		{
+			MoveCombatants();
+		},
+		[this](int32)
+		{
+			Grid.Build(Positions);
+		});
+
+	const TPair<const TCHAR*, EAreaShape> Shapes[] =
+	{
+		{ TEXT("Circle"), EAreaShape::Circle },
+		{ TEXT("Cone"), EAreaShape::Cone },
+		{ TEXT("Line"), EAreaShape::Line }
+	};
+
+	for (const TPair<const TCHAR*, EAreaShape>& Shape : Shapes)
+	{
+		FCombatAreaQuery Area;
+		const auto PickArea = [this, &Area, &Shape](int32)
+		{
+			Area = MakeRandomArea(Shape.Value);
+			Hits.Reset();
+		};
+
+		RunScenario(FString::Printf(TEXT("GridQuery%s"), Shape.Key), Iterations, PickArea,
+			[this, &Area](int32)
+			{
+				Grid.Query(Area, Hits);
+			});
+
+		// What every cast would cost if it scanned the world
+		RunScenario(FString::Printf(TEXT("ScanQuery%s"), Shape.Key), FMath::Max(1, Iterations / 10), PickArea,
+			[this, &Area](int32)
+			{
+				for (int32 Index = 0; Index < Positions.Num(); ++Index)
+				{
+					if (Area.Contains(Positions[Index]))
+					{
+						Hits.Add(Index);
+					}
+				}
+			});
+	}
+
+	// One operation is a server second: a grid rebuild per frame and the second's casts spread over the frames
+	RunScenario(TEXT("CastSecond"), FMath::Max(1, Iterations / 100),
+		[this](int32)
+		{
+			for (int32 Frame = 0; Frame < FramesPerSecond; ++Frame)
+			{
+				MoveCombatants();
+				Grid.Build(Positions);
+
+				const int32 FirstCast = Frame * CastsPerSecond / FramesPerSecond;
+				const int32 EndCast = (Frame + 1) * CastsPerSecond / FramesPerSecond;
+				for (int32 Cast = FirstCast; Cast < EndCast; ++Cast)
+				{
+					Hits.Reset();
+					Grid.Query(MakeRandomArea(static_cast<EAreaShape>(1 + Cast % 3)), Hits);
+				}
+			}
+		});
+}
+
+void UCombatAreaBenchmarkCommandlet::MoveCombatants()
+{
+	for (FVector& Position : Positions)
+	{
+		Position.X += Random.FRandRange(-MoveStep, MoveStep);
+		Position.Y += Random.FRandRange(-MoveStep, MoveStep);
+	}
+}
+
+FCombatAreaQuery UCombatAreaBenchmarkCommandlet::MakeRandomArea(EAreaShape Shape)
+{
+	const FVector& Origin = Positions[Random.RandRange(0, Positions.Num() - 1)];
+	const FVector Direction(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), 0.0f);
+	const float Range = Random.FRandRange(MinAreaRange, MaxAreaRange);
+
+	switch (Shape)
+	{
+	case EAreaShape::Cone:
+		return FCombatAreaQuery::MakeCone(Origin, Direction, Range, Random.FRandRange(15.0f, 60.0f));
+	case EAreaShape::Line:
+		return FCombatAreaQuery::MakeLine(Origin, Direction, Range, Random.FRandRange(100.0f, 300.0f));
+	default:
+		return FCombatAreaQuery::MakeCircle(Origin, Range);
+	}
+}
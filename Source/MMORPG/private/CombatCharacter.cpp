@@ -3,6 +3,7 @@
 #include "CombatCharacter.h"
 #include "ResourceComponent.h"
 #include "CombatComponent.h"
+#include "ThreatComponent.h"
 #include "CombatTypes.h"
 
 ACombatCharacter::ACombatCharacter()
@@ -36,7 +37,13 @@ void ACombatCharacter::BeginPlay()
 	// Bind to resource events
 	if (ResourceComponent)
 	{
-		ResourceComponent->OnResourceChanged.AddDynamic(this, &ACombatCharacter::OnResourceChanged);
+		ResourceComponent->OnResourcesChanged.AddDynamic(this, &ACombatCharacter::OnResourcesChanged);
+	}
+
+	// NPCs get a threat component in their Blueprint; their target follows the top of the threat table
+	if (UThreatComponent* ThreatComponent = FindComponentByClass<UThreatComponent>())
+	{
+		ThreatComponent->OnTopThreatChanged.AddDynamic(this, &ACombatCharacter::OnTopThreatChanged);
 	}
 }
 
@@ -117,35 +124,38 @@ void ACombatCharacter::OnAttackExecuted(EAttackType AttackType, AActor* Target,
 
 	// Here you could:
 	// - Play attack animation
-	// - Spawn projectile for ranged/magical attacks
+	// - Play launch VFX for ranged/magical attacks (UCombatProjectileSubsystem flies and draws the projectile)
 	// - Play attack sound/VFX
 }
 
-void ACombatCharacter::OnResourceChanged(EResourceType ResourceType, float CurrentValue, float MaxValue)
+void ACombatCharacter::OnResourcesChanged(int32 ChangedResourceMask)
 {
-	// Log resource change for debugging
-	FString ResourceName;
-	switch (ResourceType)
+	// Log the whole batch on one line; verbose only, since this fires on every hit and ability cost
+	if (UE_LOG_ACTIVE(LogTemp, Verbose) && ResourceComponent)
 	{
-	case EResourceType::Health:
-		ResourceName = "Health";
-		break;
-	case EResourceType::Mana:
-		ResourceName = "Mana";
-		break;
-	case EResourceType::Stamina:
-		ResourceName = "Stamina";
-		break;
+		const UEnum* ResourceEnum = StaticEnum<EResourceType>();
+		FString Changes;
+		for (int32 Index = 0; Index < NumCombatResourceTypes; ++Index)
+		{
+			const EResourceType ResourceType = static_cast<EResourceType>(Index);
+			if (UResourceComponent::IsResourceInMask(ChangedResourceMask, ResourceType))
+			{
+				Changes += FString::Printf(TEXT(" %s %.2f / %.2f"),
+					*ResourceEnum->GetDisplayNameTextByValue(Index).ToString(),
+					ResourceComponent->GetCurrentResource(ResourceType),
+					ResourceComponent->GetMaxResource(ResourceType));
+			}
+		}
+		UE_LOG(LogTemp, Verbose, TEXT("%s resources:%s"), *GetName(), *Changes);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("%s %s: %.2f / %.2f"), 
-		*GetName(), 
-		*ResourceName, 
-		CurrentValue, 
-		MaxValue);
-
 	// Here you could:
 	// - Update UI bars
 	// - Trigger low resource warnings
 	// - Enable/disable abilities based on resources
 }
+
+void ACombatCharacter::OnTopThreatChanged(AActor* NewTopThreat)
+{
+	SetCurrentTarget(NewTopThreat);
+}
@@ -2,68 +2,97 @@
 
 #include "CombatComponent.h"
 #include "ResourceComponent.h"
+#include "CombatRegistry.h"
+#include "CombatDamageQueue.h"
+#include "AbilityRegistry.h"
+#include "StatusEffectSubsystem.h"
+#include "CombatProjectileSubsystem.h"
+#include "ThreatComponent.h"
 #include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
 
 UCombatComponent::UCombatComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
-
-	// Initialize default melee ability
-	MeleeAbility.AbilityName = "Melee Attack";
-	MeleeAbility.AttackType = EAttackType::MeleeAttack;
-	MeleeAbility.Damage = 15.0f;
-	MeleeAbility.Range = 150.0f;
-	MeleeAbility.Cooldown = 1.0f;
-	FResourceCost MeleeStaminaCost;
-	MeleeStaminaCost.ResourceType = EResourceType::Stamina;
-	MeleeStaminaCost.Amount = 10.0f;
-	MeleeAbility.ResourceCosts.Add(MeleeStaminaCost);
-
-	// Initialize default ranged ability
-	RangedAbility.AbilityName = "Ranged Attack";
-	RangedAbility.AttackType = EAttackType::RangedAttack;
-	RangedAbility.Damage = 20.0f;
-	RangedAbility.Range = 500.0f;
-	RangedAbility.Cooldown = 1.5f;
-	FResourceCost RangedStaminaCost;
-	RangedStaminaCost.ResourceType = EResourceType::Stamina;
-	RangedStaminaCost.Amount = 15.0f;
-	RangedAbility.ResourceCosts.Add(RangedStaminaCost);
-
-	// Initialize default magical ability
-	MagicalAbility.AbilityName = "Magical Attack";
-	MagicalAbility.AttackType = EAttackType::MagicalAttack;
-	MagicalAbility.Damage = 30.0f;
-	MagicalAbility.Range = 400.0f;
-	MagicalAbility.Cooldown = 2.0f;
-	FResourceCost MagicalManaCost;
-	MagicalManaCost.ResourceType = EResourceType::Mana;
-	MagicalManaCost.Amount = 25.0f;
-	MagicalAbility.ResourceCosts.Add(MagicalManaCost);
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedComponent(true);
+
+	// Definitions live in the ability registry; these name its built-in attacks
+	MeleeAbilityName = UAbilityRegistry::DefaultMeleeAbility;
+	RangedAbilityName = UAbilityRegistry::DefaultRangedAbility;
+	MagicalAbilityName = UAbilityRegistry::DefaultMagicalAbility;
 }
 
 void UCombatComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Get reference to resource component
-	AActor* Owner = GetOwner();
-	if (Owner)
+	// Register with the world's combat registry, which looks up our resource component once
+	CombatRegistry = GetWorld() ? GetWorld()->GetSubsystem<UCombatRegistry>() : nullptr;
+	if (CombatRegistry)
+	{
+		CombatRegistry->RegisterCombatant(this);
+		ResourceComponent = CombatRegistry->FindResourceComponent(GetOwner());
+		ThreatComponent = CombatRegistry->FindThreatComponent(GetOwner());
+	}
+	else if (AActor* Owner = GetOwner())
 	{
 		ResourceComponent = Owner->FindComponentByClass<UResourceComponent>();
+		ThreatComponent = Owner->FindComponentByClass<UThreatComponent>();
+	}
+
+	DamageQueue = GetWorld() ? GetWorld()->GetSubsystem<UCombatDamageQueue>() : nullptr;
+	ProjectileSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCombatProjectileSubsystem>() : nullptr;
+
+	// Resolve ability names once; attacks then index the shared definitions directly
+	if (const UAbilityRegistry* AbilityRegistry = UAbilityRegistry::Get())
+	{
+		MeleeAbility = AbilityRegistry->FindAbility(MeleeAbilityName);
+		RangedAbility = AbilityRegistry->FindAbility(RangedAbilityName);
+		MagicalAbility = AbilityRegistry->FindAbility(MagicalAbilityName);
+	}
+}
+
+void UCombatComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearAllTimersForObject(this);
+	}
+	CooldownTimerHandles.Reset();
+
+	if (UStatusEffectSubsystem* StatusEffects = GetWorld() ? GetWorld()->GetSubsystem<UStatusEffectSubsystem>() : nullptr)
+	{
+		StatusEffects->RemoveAllEffects(this);
+	}
+
+	if (CombatRegistry)
+	{
+		CombatRegistry->UnregisterCombatant(this);
+		CombatRegistry = nullptr;
 	}
+	DamageQueue = nullptr;
+	ProjectileSubsystem = nullptr;
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void UCombatComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+bool UCombatComponent::ExecuteAttack(FAbilityHandle Ability, AActor* Target)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	return ExecuteAttackAtTime(Ability, Target, GetWorldTime());
+}
 
-	UpdateCooldowns(DeltaTime);
+bool UCombatComponent::ExecuteAttackAtTime(FAbilityHandle Ability, AActor* Target, double ServerWorldTime)
+{
+	const UAbilityRegistry* AbilityRegistry = UAbilityRegistry::Get();
+	const FAttackAbilityData* AbilityData = AbilityRegistry ? AbilityRegistry->GetAbility(Ability) : nullptr;
+	return AbilityData && ExecuteAbility(*AbilityData, Target, ServerWorldTime);
 }
 
-bool UCombatComponent::ExecuteAttack(const FAttackAbilityData& AbilityData, AActor* Target)
+bool UCombatComponent::ExecuteAbility(const FAttackAbilityData& AbilityData, AActor* Target, double TargetTime)
 {
-	if (!CanExecuteAttack(AbilityData, Target))
+	const float Range = GetAbilityRange(AbilityData);
+	if (!CanExecuteAttack(AbilityData, Range, Target, TargetTime))
 	{
 		return false;
 	}
@@ -84,13 +113,27 @@ bool UCombatComponent::ExecuteAttack(const FAttackAbilityData& AbilityData, AAct
 		FinalDamage += EquippedWeapon.BaseDamage;
 	}
 
-	// Apply damage to target
-	if (Target)
+	// Queue damage on the target; it lands with the rest of this frame's hits
+	if (AbilityData.AreaShape != EAreaShape::SingleTarget)
 	{
-		UCombatComponent* TargetCombat = Target->FindComponentByClass<UCombatComponent>();
+		QueueAreaDamage(AbilityData, Range, Target, FinalDamage);
+	}
+	else if (Target && AbilityData.ProjectileSpeed > 0.0f && ProjectileSubsystem)
+	{
+		// The projectile flies at where the target is now and can only hit the target
+		const FVector Start = GetOwner()->GetActorLocation();
+		const FVector Direction = (Target->GetActorLocation() - Start).GetSafeNormal();
+		ProjectileSubsystem->LaunchProjectile(GetOwner(), Target, Start, Direction * AbilityData.ProjectileSpeed, FinalDamage, Range);
+		MulticastProjectileLaunched(Target, Start, Direction * AbilityData.ProjectileSpeed, Range);
+	}
+	else if (Target)
+	{
+		UCombatComponent* TargetCombat = CombatRegistry
+			? CombatRegistry->FindCombatComponent(Target)
+			: Target->FindComponentByClass<UCombatComponent>();
 		if (TargetCombat)
 		{
-			TargetCombat->TakeDamage(FinalDamage, GetOwner());
+			TargetCombat->QueueDamage(FinalDamage, GetOwner());
 		}
 	}
 
@@ -100,6 +143,17 @@ bool UCombatComponent::ExecuteAttack(const FAttackAbilityData& AbilityData, AAct
 	return true;
 }
 
+void UCombatComponent::MulticastProjectileLaunched_Implementation(AActor* Target, FVector_NetQuantize Start, FVector_NetQuantize Velocity, float MaxDistance)
+{
+	// The authority already flies the real projectile
+	const AActor* Owner = GetOwner();
+	if (!Owner || Owner->HasAuthority() || !ProjectileSubsystem)
+	{
+		return;
+	}
+	ProjectileSubsystem->LaunchProjectile(GetOwner(), Target, Start, Velocity, 0.0f, MaxDistance);
+}
+
 bool UCombatComponent::ExecuteMeleeAttack(AActor* Target)
 {
 	return ExecuteAttack(MeleeAbility, Target);
@@ -117,49 +171,146 @@ bool UCombatComponent::ExecuteMagicalAttack(AActor* Target)
 
 void UCombatComponent::TakeDamage(float Damage, AActor* DamageInstigator)
 {
+	const float MitigatedDamage = MitigateDamage(Damage);
+	if (ThreatComponent)
+	{
+		ThreatComponent->AddDamageThreat(DamageInstigator, MitigatedDamage);
+	}
+
+	FResourceAmounts Drains;
+	Drains.Set(EResourceType::Health, MitigatedDamage);
+	ApplyResolvedDamage(Drains, DamageInstigator);
+}
+
+void UCombatComponent::QueueDamage(float Damage, AActor* DamageInstigator, EResourceType ResourceType)
+{
+	if (DamageQueue)
+	{
+		DamageQueue->QueueDamage(this, Damage, DamageInstigator, ResourceType);
+	}
+	else if (ResourceType == EResourceType::Health)
+	{
+		TakeDamage(Damage, DamageInstigator);
+	}
+	else
+	{
+		FResourceAmounts Drains;
+		Drains.Set(ResourceType, Damage);
+		ApplyResolvedDamage(Drains, DamageInstigator);
+	}
+}
+
+void UCombatComponent::Heal(float Amount, AActor* Healer)
+{
+	if (!ResourceComponent || Amount <= 0.0f)
+	{
+		return;
+	}
+
+	// Only the health actually restored counts as threat, so overhealing draws none
+	const float HealthBefore = ResourceComponent->GetCurrentResource(EResourceType::Health);
+	ResourceComponent->RestoreResource(EResourceType::Health, Amount);
+	const float Healed = ResourceComponent->GetCurrentResource(EResourceType::Health) - HealthBefore;
+
+	if (CombatRegistry && Healer)
+	{
+		CombatRegistry->AddHealThreat(GetOwner(), Healer, Healed);
+	}
+}
+
+float UCombatComponent::MitigateDamage(float Damage) const
+{
+	return Damage * (1.0f - FMath::Clamp(DamageMitigation + DamageMitigationModifier, 0.0f, 1.0f));
+}
+
+void UCombatComponent::ApplyResolvedDamage(const FResourceAmounts& Drains, AActor* DamageInstigator)
+{
+	// Damage may exceed what is left, so it clamps at zero instead of requiring enough
 	if (ResourceComponent)
 	{
-		ResourceComponent->ConsumeResource(EResourceType::Health, Damage);
+		FResourceAmounts Deltas;
+		for (int32 Index = 0; Index < NumCombatResourceTypes; ++Index)
+		{
+			Deltas.Amounts[Index] = -Drains.Amounts[Index];
+		}
+		ResourceComponent->ApplyResourceDeltas(Deltas, false);
 	}
 
 	// Broadcast damage taken event
-	OnDamageTaken.Broadcast(DamageInstigator, Damage);
+	const float Damage = Drains.Get(EResourceType::Health);
+	if (Damage > 0.0f)
+	{
+		OnDamageTaken.Broadcast(DamageInstigator, Damage);
+	}
 }
 
 bool UCombatComponent::IsAbilityOnCooldown(EAttackType AttackType) const
 {
-	const float* CooldownTime = AbilityCooldowns.Find(AttackType);
-	return CooldownTime && *CooldownTime > 0.0f;
+	return GetRemainingCooldown(AttackType) > 0.0f;
 }
 
 float UCombatComponent::GetRemainingCooldown(EAttackType AttackType) const
 {
-	const float* CooldownTime = AbilityCooldowns.Find(AttackType);
-	return CooldownTime ? FMath::Max(0.0f, *CooldownTime) : 0.0f;
+	const double* ExpiryTime = CooldownExpiryTimes.Find(AttackType);
+	return ExpiryTime ? static_cast<float>(FMath::Max(0.0, *ExpiryTime - GetWorldTime())) : 0.0f;
 }
 
 void UCombatComponent::SetEquippedWeapon(const FWeaponData& Weapon)
 {
+	// Abilities are shared, so the weapon's range is applied when an ability is used instead of written into it
 	EquippedWeapon = Weapon;
+}
 
-	// Update abilities based on weapon type
-	switch (Weapon.WeaponType)
+FAbilityHandle UCombatComponent::GetAbilityForAttackType(EAttackType AttackType) const
+{
+	switch (AttackType)
 	{
-	case EWeaponType::Melee:
-		MeleeAbility.Range = Weapon.AttackRange;
+	case EAttackType::MeleeAttack:
+		return MeleeAbility;
+	case EAttackType::RangedAttack:
+		return RangedAbility;
+	case EAttackType::MagicalAttack:
+		return MagicalAbility;
+	default:
+		return FAbilityHandle();
+	}
+}
+
+void UCombatComponent::SetAbilityForAttackType(EAttackType AttackType, FAbilityHandle Ability)
+{
+	switch (AttackType)
+	{
+	case EAttackType::MeleeAttack:
+		MeleeAbility = Ability;
 		break;
-	case EWeaponType::Ranged:
-		RangedAbility.Range = Weapon.AttackRange;
+	case EAttackType::RangedAttack:
+		RangedAbility = Ability;
 		break;
-	case EWeaponType::Magical:
-		MagicalAbility.Range = Weapon.AttackRange;
+	case EAttackType::MagicalAttack:
+		MagicalAbility = Ability;
 		break;
 	default:
 		break;
 	}
 }
 
-bool UCombatComponent::CanExecuteAttack(const FAttackAbilityData& AbilityData, AActor* Target)
+float UCombatComponent::GetAbilityRange(const FAttackAbilityData& AbilityData) const
+{
+	// An equipped weapon sets the range of abilities of its own kind
+	switch (EquippedWeapon.WeaponType)
+	{
+	case EWeaponType::Melee:
+		return AbilityData.AttackType == EAttackType::MeleeAttack ? EquippedWeapon.AttackRange : AbilityData.Range;
+	case EWeaponType::Ranged:
+		return AbilityData.AttackType == EAttackType::RangedAttack ? EquippedWeapon.AttackRange : AbilityData.Range;
+	case EWeaponType::Magical:
+		return AbilityData.AttackType == EAttackType::MagicalAttack ? EquippedWeapon.AttackRange : AbilityData.Range;
+	default:
+		return AbilityData.Range;
+	}
+}
+
+bool UCombatComponent::CanExecuteAttack(const FAttackAbilityData& AbilityData, float Range, AActor* Target, double TargetTime)
 {
 	// Check if on cooldown
 	if (IsAbilityOnCooldown(AbilityData.AttackType))
@@ -167,8 +318,13 @@ bool UCombatComponent::CanExecuteAttack(const FAttackAbilityData& AbilityData, A
 		return false;
 	}
 
-	// Check if target is valid and in range
-	if (!Target || !IsTargetInRange(Target, AbilityData.Range))
+	// Check if target is valid and in range; area abilities may be cast without one
+	if (!Target && AbilityData.AreaShape == EAreaShape::SingleTarget)
+	{
+		return false;
+	}
+
+	if (Target && !IsTargetInRange(Target, Range, TargetTime))
 	{
 		return false;
 	}
@@ -184,28 +340,88 @@ bool UCombatComponent::CanExecuteAttack(const FAttackAbilityData& AbilityData, A
 
 void UCombatComponent::ApplyCooldown(EAttackType AttackType, float Cooldown)
 {
-	AbilityCooldowns.Add(AttackType, Cooldown);
-}
+	if (Cooldown <= 0.0f)
+	{
+		return;
+	}
 
-void UCombatComponent::UpdateCooldowns(float DeltaTime)
-{
-	TArray<EAttackType> KeysToUpdate;
-	AbilityCooldowns.GetKeys(KeysToUpdate);
+	CooldownExpiryTimes.Add(AttackType, GetWorldTime() + Cooldown);
 
-	for (EAttackType AttackType : KeysToUpdate)
+	// One shared timer heap per world raises the expiry event; re-arming replaces any pending one
+	if (UWorld* World = GetWorld())
 	{
-		float& CooldownTime = AbilityCooldowns[AttackType];
-		CooldownTime = FMath::Max(0.0f, CooldownTime - DeltaTime);
+		FTimerHandle& TimerHandle = CooldownTimerHandles.FindOrAdd(AttackType);
+		World->GetTimerManager().SetTimer(TimerHandle,
+			FTimerDelegate::CreateUObject(this, &UCombatComponent::HandleCooldownExpired, AttackType),
+			Cooldown, false);
 	}
 }
 
-bool UCombatComponent::IsTargetInRange(AActor* Target, float Range) const
+void UCombatComponent::HandleCooldownExpired(EAttackType AttackType)
+{
+	CooldownExpiryTimes.Remove(AttackType);
+	CooldownTimerHandles.Remove(AttackType);
+	OnAbilityCooldownExpired.Broadcast(AttackType);
+}
+
+double UCombatComponent::GetWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+bool UCombatComponent::IsTargetInRange(AActor* Target, float Range, double TargetTime) const
 {
 	if (!Target || !GetOwner())
 	{
 		return false;
 	}
 
-	float Distance = FVector::Dist(GetOwner()->GetActorLocation(), Target->GetActorLocation());
-	return Distance <= Range;
+	return FVector::DistSquared(GetOwner()->GetActorLocation(), GetTargetLocationAt(Target, TargetTime)) <= FMath::Square(Range);
+}
+
+FVector UCombatComponent::GetTargetLocationAt(AActor* Target, double TargetTime) const
+{
+	// The attacker is where the server has it; only the target is rewound to what the client saw
+	FVector Location;
+	if (TargetTime < GetWorldTime() && CombatRegistry && CombatRegistry->GetCombatantLocationAt(Target, TargetTime, Location))
+	{
+		return Location;
+	}
+	return Target->GetActorLocation();
+}
+
+void UCombatComponent::QueueAreaDamage(const FAttackAbilityData& AbilityData, float Range, AActor* Target, float Damage)
+{
+	AActor* Owner = GetOwner();
+	if (!Owner)
+	{
+		return;
+	}
+
+	// Cones and lines point at the target, or straight ahead without one
+	const FVector Origin = Owner->GetActorLocation();
+	const FVector Direction = Target ? Target->GetActorLocation() - Origin : Owner->GetActorForwardVector();
+	const FCombatAreaQuery Area = FCombatAreaQuery::MakeForAbility(AbilityData, Range, Origin, Direction);
+
+	if (!CombatRegistry)
+	{
+		// Without a registry only the aimed target can be found
+		UCombatComponent* TargetCombat = Target ? Target->FindComponentByClass<UCombatComponent>() : nullptr;
+		if (TargetCombat && TargetCombat != this && Area.Contains(Target->GetActorLocation()))
+		{
+			TargetCombat->QueueDamage(Damage, Owner);
+		}
+		return;
+	}
+
+	const TArray<FCombatantEntry>& Combatants = CombatRegistry->GetCombatants();
+	for (const int32 Index : CombatRegistry->FindCombatantsInArea(Area))
+	{
+		UCombatComponent* Victim = Combatants[Index].Combat;
+		if (Victim && Victim != this)
+		{
+			Victim->QueueDamage(Damage, Owner);
+		}
+	}
 }
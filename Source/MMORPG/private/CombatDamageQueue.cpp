@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatDamageQueue.h"
+#include "CombatComponent.h"
+#include "ThreatComponent.h"
+#include "GameFramework/Actor.h"
+
+void UCombatDamageQueue::QueueDamage(UCombatComponent* Victim, float Damage, AActor* DamageInstigator, EResourceType ResourceType)
+{
+	if (!Victim || Damage <= 0.0f)
+	{
+		return;
+	}
+
+	FQueuedDamage& Record = PendingDamage.AddDefaulted_GetRef();
+	Record.Victim = Victim;
+	Record.Instigator = DamageInstigator;
+	Record.Damage = Damage;
+	Record.ResourceType = ResourceType;
+}
+
+void UCombatDamageQueue::FlushDamage()
+{
+	// A threat or damage handler flushing mid-pass would reset the buffers being iterated; its hits wait for the next tick
+	if (PendingDamage.Num() == 0 || bFlushing)
+	{
+		return;
+	}
+
+	TGuardValue<bool> FlushGuard(bFlushing, true);
+
+	// Damage events can queue more hits; those go into the emptied pending array for the next flush
+	Swap(PendingDamage, ResolvingDamage);
+
+	VictimTotals.Reset();
+	VictimTotalIndices.Reset();
+	for (const FQueuedDamage& Record : ResolvingDamage)
+	{
+		UCombatComponent* Victim = Record.Victim.Get();
+		if (!Victim)
+		{
+			continue;
+		}
+
+		int32 TotalIndex = INDEX_NONE;
+		if (const int32* ExistingIndex = VictimTotalIndices.Find(Victim))
+		{
+			TotalIndex = *ExistingIndex;
+		}
+		else
+		{
+			TotalIndex = VictimTotals.AddDefaulted();
+			VictimTotals[TotalIndex].Victim = Victim;
+			VictimTotalIndices.Add(Victim, TotalIndex);
+		}
+
+		FVictimDamage& Total = VictimTotals[TotalIndex];
+		const bool bHealthDamage = Record.ResourceType == EResourceType::Health;
+		const float ResolvedDamage = bHealthDamage ? Victim->MitigateDamage(Record.Damage) : Record.Damage;
+		Total.Drains.Add(Record.ResourceType, ResolvedDamage);
+		if (AActor* DamageInstigator = Record.Instigator.Get())
+		{
+			Total.LastInstigator = DamageInstigator;
+
+			// Totals keep only the last instigator, so threat is credited per hit
+			UThreatComponent* Threat = Victim->GetThreatComponent();
+			if (Threat && bHealthDamage)
+			{
+				Threat->AddDamageThreat(DamageInstigator, ResolvedDamage);
+			}
+		}
+	}
+	ResolvingDamage.Reset();
+
+	for (const FVictimDamage& Total : VictimTotals)
+	{
+		// An earlier victim's handlers may have destroyed this one
+		if (IsValid(Total.Victim))
+		{
+			Total.Victim->ApplyResolvedDamage(Total.Drains, Total.LastInstigator);
+		}
+	}
+}
+
+void UCombatDamageQueue::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushDamage();
+}
+
+TStatId UCombatDamageQueue::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDamageQueue, STATGROUP_Tickables);
+}
+
+bool UCombatDamageQueue::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
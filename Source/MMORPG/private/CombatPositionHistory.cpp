@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatPositionHistory.h"
+
+void FCombatPositionHistory::Record(double Time, const FVector& Position)
+{
+	// Several records in one server frame keep only the last
+	if (NumSamples > 0 && Times[GetIndex(0)] >= Time)
+	{
+		Positions[GetIndex(0)] = FVector3f(Position);
+		return;
+	}
+
+	// Above 30 Hz the newest sample slides forward until it is a full interval past the one before it,
+	// so faster ticks do not shrink the span of the buffer
+	if (NumSamples > 1 && Time - Times[GetIndex(1)] < SampleInterval)
+	{
+		Times[GetIndex(0)] = Time;
+		Positions[GetIndex(0)] = FVector3f(Position);
+		return;
+	}
+
+	Times[Head] = Time;
+	Positions[Head] = FVector3f(Position);
+	Head = (Head + 1) % Capacity;
+	NumSamples = FMath::Min(NumSamples + 1, Capacity);
+}
+
+bool FCombatPositionHistory::GetPositionAt(double Time, FVector& OutPosition) const
+{
+	if (NumSamples == 0)
+	{
+		return false;
+	}
+
+	// Walk back from the newest sample; rewinds are short, so the match is usually a few steps away
+	int32 Newer = GetIndex(0);
+	if (Time >= Times[Newer])
+	{
+		OutPosition = FVector(Positions[Newer]);
+		return true;
+	}
+
+	for (int32 Age = 1; Age < NumSamples; ++Age)
+	{
+		const int32 Older = GetIndex(Age);
+		if (Times[Older] <= Time)
+		{
+			const float Alpha = static_cast<float>((Time - Times[Older]) / (Times[Newer] - Times[Older]));
+			OutPosition = FVector(FMath::Lerp(Positions[Older], Positions[Newer], Alpha));
+			return true;
+		}
+		Newer = Older;
+	}
+
+	OutPosition = FVector(Positions[Newer]);
+	return true;
+}
@@ -0,0 +1,163 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatProjectileSubsystem.h"
+#include "CombatComponent.h"
+#include "CombatRegistry.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+void UCombatProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CombatRegistry = Collection.InitializeDependency<UCombatRegistry>();
+}
+
+void UCombatProjectileSubsystem::LaunchProjectile(AActor* ProjectileInstigator, AActor* Target, const FVector& Start, const FVector& Velocity, float Damage, float MaxDistance)
+{
+	const double Speed = Velocity.Size();
+	if (Speed <= UE_KINDA_SMALL_NUMBER || MaxDistance <= 0.0f)
+	{
+		return;
+	}
+
+	Positions.Add(Start);
+	Velocities.Add(Velocity);
+	RemainingTimes.Add(static_cast<float>(MaxDistance / Speed));
+	Damages.Add(Damage);
+	Instigators.Add(ProjectileInstigator);
+	Targets.Add(Target);
+}
+
+void UCombatProjectileSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SimulateProjectiles(DeltaTime);
+	UpdateInstances();
+}
+
+TStatId UCombatProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatProjectileSubsystem, STATGROUP_Tickables);
+}
+
+bool UCombatProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatProjectileSubsystem::SimulateProjectiles(float DeltaTime)
+{
+	FinishedProjectiles.Reset();
+
+	// Clients fly copies of the server's projectiles; they stop at the target but only the server deals damage
+	const UWorld* World = GetWorld();
+	const bool bResolvesDamage = World && World->GetNetMode() != NM_Client;
+
+	for (int32 Index = 0; Index < Positions.Num(); ++Index)
+	{
+		const FVector Step = Velocities[Index] * DeltaTime;
+
+		// Only the combatant the projectile was fired at can be hit, so allies and bystanders in its path
+		// are passed through, as with an instant single-target attack; a target that moves away is missed
+		const AActor* Target = Targets[Index].Get();
+		UCombatComponent* Victim = Target && CombatRegistry ? CombatRegistry->FindCombatComponent(Target) : nullptr;
+		if (Victim)
+		{
+			const FVector TargetLocation = Target->GetActorLocation();
+			const FVector Closest = FMath::ClosestPointOnSegment(TargetLocation, Positions[Index], Positions[Index] + Step);
+			if (FVector::DistSquared2D(Closest, TargetLocation) <= FMath::Square(HitRadius))
+			{
+				if (bResolvesDamage)
+				{
+					Victim->QueueDamage(Damages[Index], Instigators[Index].Get());
+				}
+				FinishedProjectiles.Add(Index);
+				continue;
+			}
+		}
+
+		Positions[Index] += Step;
+		RemainingTimes[Index] -= DeltaTime;
+		if (RemainingTimes[Index] <= 0.0f)
+		{
+			FinishedProjectiles.Add(Index);
+		}
+	}
+
+	// Highest first, so every row swapped into a hole has already been visited
+	for (int32 FinishedIndex = FinishedProjectiles.Num() - 1; FinishedIndex >= 0; --FinishedIndex)
+	{
+		RemoveProjectile(FinishedProjectiles[FinishedIndex]);
+	}
+}
+
+void UCombatProjectileSubsystem::UpdateInstances()
+{
+	UWorld* World = GetWorld();
+	if (!World || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	if (!InstancedMesh && !bTriedCreatingInstancedMesh)
+	{
+		bTriedCreatingInstancedMesh = true;
+		if (UStaticMesh* Mesh = ProjectileMesh.LoadSynchronous())
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.ObjectFlags |= RF_Transient;
+			AActor* MeshOwner = World->SpawnActor<AActor>(SpawnParams);
+
+			InstancedMesh = NewObject<UInstancedStaticMeshComponent>(MeshOwner);
+			InstancedMesh->SetStaticMesh(Mesh);
+			InstancedMesh->SetMobility(EComponentMobility::Movable);
+			InstancedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			InstancedMesh->SetCastShadow(false);
+			MeshOwner->SetRootComponent(InstancedMesh);
+			InstancedMesh->RegisterComponent();
+		}
+	}
+
+	if (!InstancedMesh)
+	{
+		return;
+	}
+
+	InstanceTransforms.Reset(Positions.Num());
+	for (int32 Index = 0; Index < Positions.Num(); ++Index)
+	{
+		InstanceTransforms.Emplace(Velocities[Index].Rotation(), Positions[Index]);
+	}
+
+	// Instance counts follow the projectile count; existing instances are rewritten in one batch
+	int32 NumInstances = InstancedMesh->GetInstanceCount();
+	while (NumInstances > InstanceTransforms.Num())
+	{
+		InstancedMesh->RemoveInstance(--NumInstances);
+	}
+
+	if (NumInstances > 0)
+	{
+		InstancedMesh->BatchUpdateInstancesTransforms(0, MakeArrayView(InstanceTransforms.GetData(), NumInstances), true, false, true);
+	}
+	for (int32 Index = NumInstances; Index < InstanceTransforms.Num(); ++Index)
+	{
+		InstancedMesh->AddInstance(InstanceTransforms[Index], true);
+	}
+
+	bHasRenderedInstances = InstanceTransforms.Num() > 0;
+}
+
+void UCombatProjectileSubsystem::RemoveProjectile(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	RemainingTimes.RemoveAtSwap(Index, 1, false);
+	Damages.RemoveAtSwap(Index, 1, false);
+	Instigators.RemoveAtSwap(Index, 1, false);
+	Targets.RemoveAtSwap(Index, 1, false);
+}
@@ -0,0 +1,194 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatRegistry.h"
+#include "CombatComponent.h"
+#include "ResourceComponent.h"
+#include "ThreatComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "CoreGlobals.h"
+
+void UCombatRegistry::RegisterCombatant(UCombatComponent* Combat)
+{
+	AActor* Actor = Combat ? Combat->GetOwner() : nullptr;
+	if (!Actor)
+	{
+		return;
+	}
+
+	FCombatantEntry Entry;
+	Entry.Actor = Actor;
+	Entry.Combat = Combat;
+	Entry.Resources = Actor->FindComponentByClass<UResourceComponent>();
+	Entry.Threat = Actor->FindComponentByClass<UThreatComponent>();
+
+	if (const int32* ExistingIndex = CombatantIndexByActor.Find(Actor))
+	{
+		Combatants[*ExistingIndex] = Entry;
+		PositionHistories[*ExistingIndex].Reset();
+		return;
+	}
+
+	CombatantIndexByActor.Add(Actor, Combatants.Add(Entry));
+	PositionHistories.AddDefaulted();
+	bSpatialGridDirty = true;
+}
+
+void UCombatRegistry::UnregisterCombatant(UCombatComponent* Combat)
+{
+	const AActor* Actor = Combat ? Combat->GetOwner() : nullptr;
+	const int32* IndexPtr = Actor ? CombatantIndexByActor.Find(Actor) : nullptr;
+
+	// Only the component that registered the actor may remove it
+	if (!IndexPtr || Combatants[*IndexPtr].Combat != Combat)
+	{
+		return;
+	}
+
+	const int32 Index = *IndexPtr;
+	CombatantIndexByActor.Remove(Actor);
+
+	const int32 LastIndex = Combatants.Num() - 1;
+	if (Index != LastIndex)
+	{
+		CombatantIndexByActor[Combatants[LastIndex].Actor] = Index;
+	}
+	Combatants.RemoveAtSwap(Index, 1, false);
+	PositionHistories.RemoveAtSwap(Index, 1, false);
+	bSpatialGridDirty = true;
+
+	// A combatant leaving the fight drops off every table; tables that empty remove themselves, so walk backwards
+	for (int32 TableIndex = EngagedThreatTables.Num() - 1; TableIndex >= 0; --TableIndex)
+	{
+		if (EngagedThreatTables.IsValidIndex(TableIndex))
+		{
+			EngagedThreatTables[TableIndex]->RemoveThreatTarget(Actor);
+		}
+	}
+}
+
+const FCombatantEntry* UCombatRegistry::FindCombatant(const AActor* Actor) const
+{
+	const int32* Index = CombatantIndexByActor.Find(Actor);
+	return Index ? &Combatants[*Index] : nullptr;
+}
+
+UCombatComponent* UCombatRegistry::FindCombatComponent(const AActor* Actor) const
+{
+	const FCombatantEntry* Entry = FindCombatant(Actor);
+	return Entry ? Entry->Combat : nullptr;
+}
+
+UResourceComponent* UCombatRegistry::FindResourceComponent(const AActor* Actor) const
+{
+	const FCombatantEntry* Entry = FindCombatant(Actor);
+	return Entry ? Entry->Resources : nullptr;
+}
+
+UThreatComponent* UCombatRegistry::FindThreatComponent(const AActor* Actor) const
+{
+	const FCombatantEntry* Entry = FindCombatant(Actor);
+	return Entry ? Entry->Threat : nullptr;
+}
+
+TConstArrayView<int32> UCombatRegistry::FindCombatantsInArea(const FCombatAreaQuery& Area)
+{
+	UpdateSpatialGrid();
+
+	AreaQueryResults.Reset();
+	SpatialGrid.Query(Area, AreaQueryResults);
+	return AreaQueryResults;
+}
+
+bool UCombatRegistry::GetCombatantLocationAt(const AActor* Actor, double WorldTime, FVector& OutLocation) const
+{
+	const int32* Index = CombatantIndexByActor.Find(Actor);
+	if (!Index)
+	{
+		return false;
+	}
+
+	const UWorld* World = GetWorld();
+	const double Now = World ? World->GetTimeSeconds() : WorldTime;
+	return PositionHistories[*Index].GetPositionAt(FMath::Max(WorldTime, Now - MaxRewindSeconds), OutLocation);
+}
+
+void UCombatRegistry::SetThreatTableEngaged(UThreatComponent* Threat, bool bEngaged)
+{
+	if (bEngaged)
+	{
+		EngagedThreatTables.AddUnique(Threat);
+	}
+	else
+	{
+		EngagedThreatTables.RemoveSingleSwap(Threat, false);
+	}
+}
+
+void UCombatRegistry::AddHealThreat(const AActor* HealedActor, AActor* Healer, float Healing)
+{
+	if (!HealedActor || !Healer || Healing <= 0.0f)
+	{
+		return;
+	}
+
+	for (int32 TableIndex = EngagedThreatTables.Num() - 1; TableIndex >= 0; --TableIndex)
+	{
+		UThreatComponent* Threat = EngagedThreatTables.IsValidIndex(TableIndex) ? EngagedThreatTables[TableIndex] : nullptr;
+		if (Threat && Threat->GetOwner() != Healer && Threat->HasThreat(HealedActor))
+		{
+			Threat->AddHealThreat(Healer, Healing);
+		}
+	}
+}
+
+void UCombatRegistry::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// One sample per combatant per server frame, written in place into each fixed-size history
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (int32 Index = 0; Index < Combatants.Num(); ++Index)
+	{
+		if (const AActor* Actor = Combatants[Index].Actor)
+		{
+			PositionHistories[Index].Record(Now, Actor->GetActorLocation());
+		}
+	}
+}
+
+bool UCombatRegistry::IsTickable() const
+{
+	// Only the server validates attacks, so clients keep no history
+	const UWorld* World = GetWorld();
+	return Combatants.Num() > 0 && World && World->GetNetMode() != NM_Client;
+}
+
+TStatId UCombatRegistry::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatRegistry, STATGROUP_Tickables);
+}
+
+void UCombatRegistry::UpdateSpatialGrid()
+{
+	if (!bSpatialGridDirty && SpatialGridFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	// Combatants move every frame, so a bulk rebuild is cheaper than tracking each move
+	CombatantPositions.Reset(Combatants.Num());
+	for (const FCombatantEntry& Entry : Combatants)
+	{
+		CombatantPositions.Add(Entry.Actor ? Entry.Actor->GetActorLocation() : FVector::ZeroVector);
+	}
+
+	SpatialGrid.Build(CombatantPositions);
+	SpatialGridFrame = GFrameCounter;
+	bSpatialGridDirty = false;
+}
+
+bool UCombatRegistry::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
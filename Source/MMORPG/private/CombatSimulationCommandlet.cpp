@@ -0,0 +1,166 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatSimulationCommandlet.h"
+#include "CombatCharacter.h"
+#include "CombatComponent.h"
+#include "ResourceComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+namespace
+{
+	// Squad mates stand within melee range of each other; squads are far enough apart not to mix
+	constexpr int32 SquadSize = 8;
+	constexpr float SquadRadius = 60.0f;
+	constexpr float SquadSpacing = 2000.0f;
+
+	// Chance per frame that a combatant tries an attack; cooldowns and costs reject many of them
+	constexpr float AttackChancePerFrame = 0.2f;
+}
+
+void UCombatSimulationCommandlet::ParseParams(const FString& Params)
+{
+	FString PopulationList = TEXT("100,1000,10000");
+	FParse::Value(*Params, TEXT("combatants="), PopulationList, false);
+
+	TArray<FString> Sizes;
+	PopulationList.ParseIntoArray(Sizes, TEXT(","));
+	PopulationSizes.Reset();
+	for (const FString& Size : Sizes)
+	{
+		const int32 NumCombatants = FCString::Atoi(*Size);
+		if (NumCombatants > 0)
+		{
+			PopulationSizes.Add(NumCombatants);
+		}
+	}
+
+	FParse::Value(*Params, TEXT("frames="), NumFrames);
+	FParse::Value(*Params, TEXT("tickrate="), TickRate);
+	NumFrames = FMath::Max(1, NumFrames);
+	TickRate = FMath::Max(1, TickRate);
+}
+
+void UCombatSimulationCommandlet::RunScenarios()
+{
+	const FScopedFixedTimeStep FixedTimeStep(TickRate, true);
+	for (const int32 NumCombatants : PopulationSizes)
+	{
+		RunPopulation(NumCombatants);
+	}
+}
+
+void UCombatSimulationCommandlet::RunPopulation(int32 NumCombatants)
+{
+	UWorld* World = CreateBenchmarkWorld(TEXT("CombatSimulation"));
+	Combatants.Reset();
+	Combatants.Reserve(NumCombatants);
+
+	const int32 SquadsPerRow = FMath::Max(1, FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumCombatants) / SquadSize)));
+	RunScenario(FString::Printf(TEXT("Spawn%d"), NumCombatants), NumCombatants,
+		[this, World, SquadsPerRow](int32 Index)
+		{
+			const int32 Squad = Index / SquadSize;
+			const float Angle = 2.0f * PI * (Index % SquadSize) / SquadSize;
+			const FVector Location(
+				(Squad % SquadsPerRow) * SquadSpacing + SquadRadius * FMath::Cos(Angle),
+				(Squad / SquadsPerRow) * SquadSpacing + SquadRadius * FMath::Sin(Angle),
+				100.0f);
+
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			ACombatCharacter* Character = World->SpawnActor<ACombatCharacter>(ACombatCharacter::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+
+			// There is no ground to stand on, and movement is not what is being measured
+			Character->GetCharacterMovement()->DisableMovement();
+
+			FSimulatedCombatant& Combatant = Combatants.AddDefaulted_GetRef();
+			Combatant.Character = Character;
+			Combatant.Combat = Character->FindComponentByClass<UCombatComponent>();
+			Combatant.Resources = Character->FindComponentByClass<UResourceComponent>();
+		});
+
+	// Spawning keeps every combatant alive, so the scenario's heap growth is what the population costs
+	AddResultMetric(TEXT("BytesPerCombatant"), static_cast<double>(GetLastResult().PeakLiveBytes) / NumCombatants);
+
+	for (int32 Index = 0; Index < Combatants.Num(); ++Index)
+	{
+		const int32 SquadStart = Index - Index % SquadSize;
+		const int32 SquadEnd = FMath::Min(SquadStart + SquadSize, Combatants.Num());
+		int32 TargetIndex = Random.RandRange(SquadStart, SquadEnd - 1);
+		if (TargetIndex == Index)
+		{
+			TargetIndex = TargetIndex + 1 < SquadEnd ? TargetIndex + 1 : SquadStart;
+		}
+		Combatants[Index].Target = TargetIndex != Index ? Combatants[TargetIndex].Character : nullptr;
+		Combatants[Index].Character->SetCurrentTarget(Combatants[Index].Target);
+	}
+
+	const float DeltaTime = 1.0f / TickRate;
+	int64 AttackAttempts = 0;
+	int64 Attacks = 0;
+	RunScenario(FString::Printf(TEXT("Simulate%d"), NumCombatants), NumFrames,
+		[this](int32 Frame)
+		{
+			// Once per simulated second, outside the measurement
+			if (Frame % TickRate == 0)
+			{
+				RestoreCombatants();
+			}
+		},
+		[this, World, DeltaTime, &AttackAttempts, &Attacks](int32)
+		{
+			for (const FSimulatedCombatant& Combatant : Combatants)
+			{
+				if (!Combatant.Target || Random.GetFraction() >= AttackChancePerFrame)
+				{
+					continue;
+				}
+
+				++AttackAttempts;
+				bool bAttacked = false;
+				switch (Random.RandRange(0, 2))
+				{
+				case 0:
+					bAttacked = Combatant.Combat->ExecuteMeleeAttack(Combatant.Target);
+					break;
+				case 1:
+					bAttacked = Combatant.Combat->ExecuteRangedAttack(Combatant.Target);
+					break;
+				default:
+					bAttacked = Combatant.Combat->ExecuteMagicalAttack(Combatant.Target);
+					break;
+				}
+				Attacks += bAttacked ? 1 : 0;
+			}
+
+			// Applies the frame's queued damage and fires cooldown timers
+			World->Tick(LEVELTICK_All, DeltaTime);
+		});
+
+	const FBenchmarkResult& Result = GetLastResult();
+	AddResultMetric(TEXT("AttackAttempts"), static_cast<double>(AttackAttempts));
+	AddResultMetric(TEXT("Attacks"), static_cast<double>(Attacks));
+	AddResultMetric(TEXT("AttacksPerSecond"), Result.TotalSeconds > 0.0 ? Attacks / Result.TotalSeconds : 0.0);
+	AddResultMetric(TEXT("AttacksPerSimulatedSecond"), static_cast<double>(Attacks) * TickRate / NumFrames);
+	AddResultMetric(TEXT("AllocationsPerAttack"), Attacks > 0 ? static_cast<double>(Result.Allocations) / Attacks : 0.0);
+	AddResultMetric(TEXT("FrameP50Ms"), Result.P50Nanoseconds / 1.0e6);
+	AddResultMetric(TEXT("FrameP95Ms"), Result.P95Nanoseconds / 1.0e6);
+	AddResultMetric(TEXT("FrameP99Ms"), Result.P99Nanoseconds / 1.0e6);
+
+	Combatants.Reset();
+	DestroyBenchmarkWorld(World);
+}
+
+void UCombatSimulationCommandlet::RestoreCombatants()
+{
+	for (const FSimulatedCombatant& Combatant : Combatants)
+	{
+		if (Combatant.Resources)
+		{
+			Combatant.Resources->RestoreResource(EResourceType::Health, Combatant.Resources->GetMaxResource(EResourceType::Health));
+			Combatant.Resources->RestoreResource(EResourceType::Mana, Combatant.Resources->GetMaxResource(EResourceType::Mana));
+			Combatant.Resources->RestoreResource(EResourceType::Stamina, Combatant.Resources->GetMaxResource(EResourceType::Stamina));
+		}
+	}
+}
@@ -0,0 +1,268 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatSpatialGrid.h"
+
+namespace
+{
+	// Shape test on an offset from the area's origin, using squared distances only
+	bool IsOffsetInArea(const FCombatAreaQuery& Area, float Dx, float Dy, float Dz)
+	{
+		const float DistSquared = Dx * Dx + Dy * Dy + Dz * Dz;
+		const float Along = Dx * static_cast<float>(Area.Direction.X)
+			+ Dy * static_cast<float>(Area.Direction.Y)
+			+ Dz * static_cast<float>(Area.Direction.Z);
+
+		switch (Area.Shape)
+		{
+		case EAreaShape::Cone:
+			return DistSquared <= Area.RangeSquared && Along >= 0.0f && Along * Along >= Area.ConeCosSquared * DistSquared;
+		case EAreaShape::Line:
+			return Along >= 0.0f && Along <= Area.Range && DistSquared - Along * Along <= Area.LineHalfWidthSquared;
+		default:
+			return DistSquared <= Area.RangeSquared;
+		}
+	}
+
+	FVector GetSafeDirection(const FVector& Direction)
+	{
+		const FVector Normal = Direction.GetSafeNormal();
+		return Normal.IsZero() ? FVector::ForwardVector : Normal;
+	}
+}
+
+FCombatAreaQuery FCombatAreaQuery::MakeCircle(const FVector& Origin, float Radius)
+{
+	FCombatAreaQuery Area;
+	Area.Shape = EAreaShape::Circle;
+	Area.Origin = Origin;
+	Area.Range = FMath::Max(Radius, 0.0f);
+	Area.RangeSquared = Area.Range * Area.Range;
+	return Area;
+}
+
+FCombatAreaQuery FCombatAreaQuery::MakeCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngleDegrees)
+{
+	FCombatAreaQuery Area = MakeCircle(Origin, Length);
+	Area.Shape = EAreaShape::Cone;
+	Area.Direction = GetSafeDirection(Direction);
+
+	// Comparing squares only works for cones no wider than a half space
+	const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.0f, 90.0f)));
+	Area.ConeCosSquared = CosHalfAngle * CosHalfAngle;
+	return Area;
+}
+
+FCombatAreaQuery FCombatAreaQuery::MakeLine(const FVector& Origin, const FVector& Direction, float Length, float Width)
+{
+	FCombatAreaQuery Area = MakeCircle(Origin, Length);
+	Area.Shape = EAreaShape::Line;
+	Area.Direction = GetSafeDirection(Direction);
+
+	const float HalfWidth = FMath::Max(Width, 0.0f) * 0.5f;
+	Area.LineHalfWidthSquared = HalfWidth * HalfWidth;
+	return Area;
+}
+
+FCombatAreaQuery FCombatAreaQuery::MakeForAbility(const FAttackAbilityData& Ability, float Range, const FVector& Origin, const FVector& Direction)
+{
+	switch (Ability.AreaShape)
+	{
+	case EAreaShape::Cone:
+		return MakeCone(Origin, Direction, Range, Ability.ConeHalfAngle);
+	case EAreaShape::Line:
+		return MakeLine(Origin, Direction, Range, Ability.LineWidth);
+	default:
+		return MakeCircle(Origin, Range);
+	}
+}
+
+bool FCombatAreaQuery::Contains(const FVector& Point) const
+{
+	const FVector Offset = Point - Origin;
+	return IsOffsetInArea(*this, static_cast<float>(Offset.X), static_cast<float>(Offset.Y), static_cast<float>(Offset.Z));
+}
+
+FBox2D FCombatAreaQuery::GetBounds() const
+{
+	if (Shape != EAreaShape::Line)
+	{
+		const FVector2D Extent(Range, Range);
+		return FBox2D(FVector2D(Origin) - Extent, FVector2D(Origin) + Extent);
+	}
+
+	const FVector2D Start(Origin);
+	const FVector2D End(Origin + Direction * Range);
+	const float HalfWidth = FMath::Sqrt(LineHalfWidthSquared);
+	const FVector2D Extent(HalfWidth, HalfWidth);
+	return FBox2D(FVector2D::Min(Start, End) - Extent, FVector2D::Max(Start, End) + Extent);
+}
+
+FCombatSpatialGrid::FCombatSpatialGrid(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+	, InvCellSize(1.0f / FMath::Max(InCellSize, 1.0f))
+{
+}
+
+void FCombatSpatialGrid::Build(TArrayView<const FVector> Positions)
+{
+	const int32 NumPositions = Positions.Num();
+
+	// About one bucket per position keeps buckets short without a cell map
+	const int32 NumBuckets = static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(NumPositions, 16))));
+	BucketMask = NumBuckets - 1;
+
+	// Count entries per bucket, then turn the counts into bucket end offsets
+	BucketStarts.Reset();
+	BucketStarts.SetNumZeroed(NumBuckets + 1);
+	EntryBuckets.SetNumUninitialized(NumPositions, false);
+	for (int32 Index = 0; Index < NumPositions; ++Index)
+	{
+		const FVector& Position = Positions[Index];
+		const int32 Bucket = GetBucket(FMath::FloorToInt32(Position.X * InvCellSize), FMath::FloorToInt32(Position.Y * InvCellSize));
+		EntryBuckets[Index] = Bucket;
+		++BucketStarts[Bucket];
+	}
+	for (int32 Bucket = 1; Bucket < NumBuckets; ++Bucket)
+	{
+		BucketStarts[Bucket] += BucketStarts[Bucket - 1];
+	}
+	BucketStarts[NumBuckets] = NumPositions;
+
+	// Filling backwards walks each end offset down to its bucket's start and keeps entries in input order
+	SortedIndices.SetNumUninitialized(NumPositions, false);
+	SortedX.SetNumUninitialized(NumPositions, false);
+	SortedY.SetNumUninitialized(NumPositions, false);
+	SortedZ.SetNumUninitialized(NumPositions, false);
+	for (int32 Index = NumPositions - 1; Index >= 0; --Index)
+	{
+		const int32 Slot = --BucketStarts[EntryBuckets[Index]];
+		const FVector& Position = Positions[Index];
+		SortedIndices[Slot] = Index;
+		SortedX[Slot] = static_cast<float>(Position.X);
+		SortedY[Slot] = static_cast<float>(Position.Y);
+		SortedZ[Slot] = static_cast<float>(Position.Z);
+	}
+
+	VisitedBuckets.Init(false, NumBuckets);
+}
+
+void FCombatSpatialGrid::Query(const FCombatAreaQuery& Area, TArray<int32>& OutIndices) const
+{
+	if (SortedIndices.Num() == 0)
+	{
+		return;
+	}
+
+	const FBox2D Bounds = Area.GetBounds();
+	const int32 MinCellX = FMath::FloorToInt32(Bounds.Min.X * InvCellSize);
+	const int32 MinCellY = FMath::FloorToInt32(Bounds.Min.Y * InvCellSize);
+	const int32 MaxCellX = FMath::FloorToInt32(Bounds.Max.X * InvCellSize);
+	const int32 MaxCellY = FMath::FloorToInt32(Bounds.Max.Y * InvCellSize);
+	const int64 NumCells = (static_cast<int64>(MaxCellX) - MinCellX + 1) * (static_cast<int64>(MaxCellY) - MinCellY + 1);
+	const int32 NumBuckets = BucketMask + 1;
+
+	// An area covering more cells than there are buckets touches every bucket anyway
+	if (NumCells >= NumBuckets)
+	{
+		for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+		{
+			QueryBucket(Area, Bucket, OutIndices);
+		}
+		return;
+	}
+
+	// Cells that hash to the same bucket must only be searched once
+	VisitedBucketList.Reset();
+	for (int32 CellY = MinCellY; CellY <= MaxCellY; ++CellY)
+	{
+		for (int32 CellX = MinCellX; CellX <= MaxCellX; ++CellX)
+		{
+			const int32 Bucket = GetBucket(CellX, CellY);
+			if (!VisitedBuckets[Bucket])
+			{
+				VisitedBuckets[Bucket] = true;
+				VisitedBucketList.Add(Bucket);
+			}
+		}
+	}
+
+	for (const int32 Bucket : VisitedBucketList)
+	{
+		QueryBucket(Area, Bucket, OutIndices);
+		VisitedBuckets[Bucket] = false;
+	}
+}
+
+int32 FCombatSpatialGrid::GetBucket(int32 CellX, int32 CellY) const
+{
+	const uint32 Hash = (static_cast<uint32>(CellX) * 73856093u) ^ (static_cast<uint32>(CellY) * 19349663u);
+	return static_cast<int32>(Hash & static_cast<uint32>(BucketMask));
+}
+
+void FCombatSpatialGrid::QueryBucket(const FCombatAreaQuery& Area, int32 Bucket, TArray<int32>& OutIndices) const
+{
+	const int32 End = BucketStarts[Bucket + 1];
+	int32 Slot = BucketStarts[Bucket];
+
+	const float OriginX = static_cast<float>(Area.Origin.X);
+	const float OriginY = static_cast<float>(Area.Origin.Y);
+	const float OriginZ = static_cast<float>(Area.Origin.Z);
+
+	// Four candidates per step; entries from other cells sharing the bucket are rejected by the shape test
+	const VectorRegister4Float VecOriginX = VectorSetFloat1(OriginX);
+	const VectorRegister4Float VecOriginY = VectorSetFloat1(OriginY);
+	const VectorRegister4Float VecOriginZ = VectorSetFloat1(OriginZ);
+	const VectorRegister4Float VecDirX = VectorSetFloat1(static_cast<float>(Area.Direction.X));
+	const VectorRegister4Float VecDirY = VectorSetFloat1(static_cast<float>(Area.Direction.Y));
+	const VectorRegister4Float VecDirZ = VectorSetFloat1(static_cast<float>(Area.Direction.Z));
+	const VectorRegister4Float VecRange = VectorSetFloat1(Area.Range);
+	const VectorRegister4Float VecRangeSquared = VectorSetFloat1(Area.RangeSquared);
+	const VectorRegister4Float VecConeCosSquared = VectorSetFloat1(Area.ConeCosSquared);
+	const VectorRegister4Float VecLineHalfWidthSquared = VectorSetFloat1(Area.LineHalfWidthSquared);
+	const VectorRegister4Float VecZero = VectorZeroFloat();
+
+	for (; Slot + 4 <= End; Slot += 4)
+	{
+		const VectorRegister4Float Dx = VectorSubtract(VectorLoad(&SortedX[Slot]), VecOriginX);
+		const VectorRegister4Float Dy = VectorSubtract(VectorLoad(&SortedY[Slot]), VecOriginY);
+		const VectorRegister4Float Dz = VectorSubtract(VectorLoad(&SortedZ[Slot]), VecOriginZ);
+		const VectorRegister4Float DistSquared = VectorMultiplyAdd(Dz, Dz, VectorMultiplyAdd(Dy, Dy, VectorMultiply(Dx, Dx)));
+
+		VectorRegister4Float Mask;
+		switch (Area.Shape)
+		{
+		case EAreaShape::Cone:
+		{
+			const VectorRegister4Float Along = VectorMultiplyAdd(Dz, VecDirZ, VectorMultiplyAdd(Dy, VecDirY, VectorMultiply(Dx, VecDirX)));
+			Mask = VectorBitwiseAnd(
+				VectorBitwiseAnd(VectorCompareLE(DistSquared, VecRangeSquared), VectorCompareGE(Along, VecZero)),
+				VectorCompareGE(VectorMultiply(Along, Along), VectorMultiply(DistSquared, VecConeCosSquared)));
+			break;
+		}
+		case EAreaShape::Line:
+		{
+			const VectorRegister4Float Along = VectorMultiplyAdd(Dz, VecDirZ, VectorMultiplyAdd(Dy, VecDirY, VectorMultiply(Dx, VecDirX)));
+			Mask = VectorBitwiseAnd(
+				VectorBitwiseAnd(VectorCompareGE(Along, VecZero), VectorCompareLE(Along, VecRange)),
+				VectorCompareLE(VectorSubtract(DistSquared, VectorMultiply(Along, Along)), VecLineHalfWidthSquared));
+			break;
+		}
+		default:
+			Mask = VectorCompareLE(DistSquared, VecRangeSquared);
+			break;
+		}
+
+		for (uint32 Lanes = static_cast<uint32>(VectorMaskBits(Mask)); Lanes != 0; Lanes &= Lanes - 1)
+		{
+			OutIndices.Add(SortedIndices[Slot + static_cast<int32>(FMath::CountTrailingZeros(Lanes))]);
+		}
+	}
+
+	for (; Slot < End; ++Slot)
+	{
+		if (IsOffsetInArea(Area, SortedX[Slot] - OriginX, SortedY[Slot] - OriginY, SortedZ[Slot] - OriginZ))
+		{
+			OutIndices.Add(SortedIndices[Slot]);
+		}
+	}
+}
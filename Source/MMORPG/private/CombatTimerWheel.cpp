@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatTimerWheel.h"
+
+FCombatTimerWheel::FCombatTimerWheel()
+{
+	for (int32& Head : SlotHeads)
+	{
+		Head = INDEX_NONE;
+	}
+}
+
+FCombatTimerHandle FCombatTimerWheel::Schedule(uint64 DelayTicks, uint32 Payload)
+{
+	int32 NodeIndex = FirstFreeNode;
+	if (NodeIndex != INDEX_NONE)
+	{
+		FirstFreeNode = Nodes[NodeIndex].Next;
+	}
+	else
+	{
+		NodeIndex = Nodes.AddDefaulted();
+	}
+
+	FNode& Node = Nodes[NodeIndex];
+	Node.ExpiryTick = CurrentTick + FMath::Clamp<uint64>(DelayTicks, 1, MaxDelayTicks);
+	Node.Payload = Payload;
+	Insert(NodeIndex);
+	++NumPending;
+
+	FCombatTimerHandle Handle;
+	Handle.Index = NodeIndex;
+	Handle.Generation = Node.Generation;
+	return Handle;
+}
+
+bool FCombatTimerWheel::Cancel(FCombatTimerHandle& Handle)
+{
+	const bool bPending = IsPending(Handle);
+	if (bPending)
+	{
+		Unlink(Handle.Index);
+		Release(Handle.Index);
+	}
+	Handle.Invalidate();
+	return bPending;
+}
+
+bool FCombatTimerWheel::IsPending(const FCombatTimerHandle& Handle) const
+{
+	return Nodes.IsValidIndex(Handle.Index)
+		&& Nodes[Handle.Index].Generation == Handle.Generation
+		&& Nodes[Handle.Index].Slot != INDEX_NONE;
+}
+
+void FCombatTimerWheel::Advance(uint64 ToTick, TArray<uint32>& OutPayloads)
+{
+	while (CurrentTick < ToTick)
+	{
+		// Nothing can fire, so there is no need to walk the empty ticks
+		if (NumPending == 0)
+		{
+			CurrentTick = ToTick;
+			return;
+		}
+
+		++CurrentTick;
+
+		// Refill the lower levels from each coarser slot that has just come round
+		for (int32 Level = 1; Level < NumLevels; ++Level)
+		{
+			if ((CurrentTick & ((uint64(1) << (SlotBits * Level)) - 1)) != 0)
+			{
+				break;
+			}
+			Cascade(Level);
+		}
+
+		// Everything left in this tick's finest slot is due now
+		int32& Head = SlotHeads[CurrentTick & (SlotsPerLevel - 1)];
+		while (Head != INDEX_NONE)
+		{
+			const int32 NodeIndex = Head;
+			OutPayloads.Add(Nodes[NodeIndex].Payload);
+			Unlink(NodeIndex);
+			Release(NodeIndex);
+		}
+	}
+}
+
+void FCombatTimerWheel::Insert(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	const uint64 Delta = Node.ExpiryTick - CurrentTick;
+
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && Delta >= (uint64(1) << (SlotBits * (Level + 1))))
+	{
+		++Level;
+	}
+
+	const int32 Slot = Level * SlotsPerLevel + static_cast<int32>((Node.ExpiryTick >> (SlotBits * Level)) & (SlotsPerLevel - 1));
+	Node.Slot = Slot;
+	Node.Prev = INDEX_NONE;
+	Node.Next = SlotHeads[Slot];
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = NodeIndex;
+	}
+	SlotHeads[Slot] = NodeIndex;
+}
+
+void FCombatTimerWheel::Unlink(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	if (Node.Prev != INDEX_NONE)
+	{
+		Nodes[Node.Prev].Next = Node.Next;
+	}
+	else
+	{
+		SlotHeads[Node.Slot] = Node.Next;
+	}
+
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = Node.Prev;
+	}
+}
+
+void FCombatTimerWheel::Release(int32 NodeIndex)
+{
+	// Bumping the generation makes every outstanding handle to this node stale
+	FNode& Node = Nodes[NodeIndex];
+	Node.Slot = INDEX_NONE;
+	Node.Prev = INDEX_NONE;
+	Node.Next = FirstFreeNode;
+	++Node.Generation;
+	FirstFreeNode = NodeIndex;
+	--NumPending;
+}
+
+void FCombatTimerWheel::Cascade(int32 Level)
+{
+	const int32 Slot = Level * SlotsPerLevel + static_cast<int32>((CurrentTick >> (SlotBits * Level)) & (SlotsPerLevel - 1));
+
+	int32 NodeIndex = SlotHeads[Slot];
+	SlotHeads[Slot] = INDEX_NONE;
+	while (NodeIndex != INDEX_NONE)
+	{
+		const int32 Next = Nodes[NodeIndex].Next;
+		Insert(NodeIndex);
+		NodeIndex = Next;
+	}
+}
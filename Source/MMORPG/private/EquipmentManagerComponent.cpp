@@ -73,14 +73,8 @@ void UEquipmentManagerComponent::RecalculateModifiers()
 		CacheComponentReferences();
 	}
 
-	// Reset all modifiers to zero
-	if (AttributesComponent)
-	{
-		AttributesComponent->ApplyMaxHPModifier(0.0f);
-		AttributesComponent->ApplyMaxManaModifier(0.0f);
-		AttributesComponent->ApplyMaxStaminaModifier(0.0f);
-	}
-
+	// Reset skill modifiers to zero; attribute modifiers are set to their new totals below, since
+	// zeroing them first would clamp current HP, Mana and Stamina to the unmodified maximums
 	if (SkillsComponent)
 	{
 		SkillsComponent->RemoveSkillEquipmentModifier(ESkillType::Toughness);
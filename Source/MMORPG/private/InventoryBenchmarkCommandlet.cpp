@@ -0,0 +1,472 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "InventoryBenchmarkCommandlet.h"
+#include "InventoryComponent.h"
+#include "Item.h"
+#include "ItemRegistry.h"
+#include "UObject/Package.h"
+
+namespace
+{
+	// Far above any authored ItemID so benchmark definitions never replace real ones
+	constexpr int32 FirstBenchmarkItemID = 900000;
+	constexpr int32 NumBenchmarkItems = 64;
+
+	// Replication estimate: one player looting continuously into a 100-slot bag, sent to its owner at 30 Hz
+	constexpr int32 ReplicationSlots = 100;
+	constexpr int32 NetUpdateRate = 30;
+	constexpr int32 LootSeconds = 60;
+	constexpr float LootsPerSecond = 2.0f;
+	constexpr int32 MaxItemsPerLoot = 4;
+
+	// When the bag is this close to full the player sells a handful of slots to a vendor
+	constexpr int32 VendorFreeSlots = 10;
+	constexpr int32 SlotsSoldPerVendor = 8;
+
+	// Rep layout framing, as in the vitals replication benchmark: a subobject reference and payload size,
+	// then handle-prefixed properties ending in a null handle
+	constexpr int32 SubobjectHeaderBits = 32;
+	constexpr int32 HandleBits = 8;
+	constexpr int32 ArrayNumBits = 16;
+	constexpr int32 IntBits = 32;
+	constexpr int32 NullObjectBits = 8;
+
+	// FInventorySlot: ItemID, Quantity and a null Instance, each behind a handle, then a closing handle
+	constexpr int32 SlotBits = 2 * (HandleBits + IntBits) + HandleBits + NullObjectBits + HandleBits;
+
+	// FFastArraySerializer delta: array and base replication keys and the delete and change counts,
+	// then an ID per deleted entry and an ID plus the whole item per changed one
+	constexpr int32 FastArrayHeaderBits = 4 * IntBits;
+	constexpr int32 FastArrayIDBits = IntBits;
+
+	// FReplicatedInventorySlot: SlotIndex, ItemID and Quantity, then an empty InstanceData array and a closing handle
+	constexpr int32 FastArrayItemBits = 3 * (HandleBits + IntBits) + HandleBits + ArrayNumBits + HandleBits;
+
+	// Garbage collection: every online player's bag loaded at once, each a default 30-slot bag three quarters full
+	constexpr int32 PlayerBagSlots = 30;
+	constexpr int32 PlayerBagAdds = PlayerBagSlots * 3 / 4;
+	constexpr int32 GarbageCollections = 10;
+
+	// The first half of the benchmark items stack; the rest are unstackable gear
+	int32 GetBenchmarkQuantity(int32 ItemID, FRandomStream& Random, int32 MaxStackQuantity)
+	{
+		return ItemID < FirstBenchmarkItemID + NumBenchmarkItems / 2 ? Random.RandRange(1, MaxStackQuantity) : 1;
+	}
+}
+
+void UInventoryBenchmarkCommandlet::ParseParams(const FString& Params)
+{
+	// A starting bag, a player's whole stash and a guild bank; costs that grow with slot count show up across them
+	FString SlotList = TEXT("30,300,3000");
+	FParse::Value(*Params, TEXT("slots="), SlotList, false);
+
+	TArray<FString> Sizes;
+	SlotList.ParseIntoArray(Sizes, TEXT(","));
+	SlotCounts.Reset();
+	for (const FString& Size : Sizes)
+	{
+		const int32 NumSlots = FCString::Atoi(*Size);
+		if (NumSlots > 0)
+		{
+			SlotCounts.Add(NumSlots);
+		}
+	}
+
+	FParse::Value(*Params, TEXT("players="), NumPlayers);
+	NumPlayers = FMath::Max(1, NumPlayers);
+}
+
+void UInventoryBenchmarkCommandlet::RunScenarios()
+{
+	RegisterBenchmarkItems();
+
+	for (const int32 NumSlots : SlotCounts)
+	{
+		RunSlotCount(NumSlots);
+	}
+
+	RunReplicationEstimate();
+
+	// The registry layout against a UItem object per slot, as slots held before the registry
+	RunPlayerInventories(TEXT("IdSlots"), false);
+	RunPlayerInventories(TEXT("InstanceSlots"), true);
+}
+
+void UInventoryBenchmarkCommandlet::RunSlotCount(int32 NumSlots)
+{
+	Inventory = NewObject<UInventoryComponent>(GetTransientPackage());
+	Inventory->MaxSlots = NumSlots;
+	Inventory->MaxWeight = 1.0e9f;
+	Inventory->ClearInventory();
+
+	// Fill levels are fractions of the bag so every size sees the same occupancy
+	const auto ScenarioName = [NumSlots](const TCHAR* Name)
+	{
+		return FString::Printf(TEXT("%s%d"), Name, NumSlots);
+	};
+
+	// A mob drop: several different items in one transaction, emptying the bag when it fills up
+	FInventoryTransaction LootDrop;
+	RunScenario(ScenarioName(TEXT("LootBurst")), Iterations,
+		[this, &LootDrop](int32)
+		{
+			if (Inventory->GetEmptySlotCount() < 12)
+			{
+				Inventory->ClearInventory();
+			}
+
+			LootDrop.ItemsToAdd.Reset();
+			for (int32 i = 0; i < 6; ++i)
+			{
+				const int32 ItemID = GetRandomItemID();
+				LootDrop.ItemsToAdd.Emplace(ItemID, GetBenchmarkQuantity(ItemID, Random, 10));
+			}
+		},
+		[this, &LootDrop](int32)
+		{
+			Inventory->ApplyTransaction(LootDrop);
+		});
+
+	// Crafting and consumption: repeated small adds and removes against partial stacks
+	FillInventory(NumSlots / 3);
+	RunScenario(ScenarioName(TEXT("StackChurn")), Iterations,
+		[this](int32 Operation)
+		{
+			const int32 ItemID = FirstBenchmarkItemID + (Operation / 2) % (NumBenchmarkItems / 2);
+			if (Operation % 2 == 0)
+			{
+				Inventory->AddItemByID(ItemID, 1 + Operation % 15);
+			}
+			else
+			{
+				Inventory->RemoveItemByID(ItemID, FMath::Min(1 + Operation % 7, Inventory->GetItemQuantityByID(ItemID)));
+			}
+		});
+
+	// A fragmented bag: random stacks with random slots partly drained
+	const auto FragmentInventory = [this, NumSlots](int32)
+	{
+		FillInventory(NumSlots * 2 / 3);
+		for (int32 i = 0; i < NumSlots / 3; ++i)
+		{
+			const int32 SlotIndex = Random.RandRange(0, NumSlots - 1);
+			const int32 Quantity = Inventory->GetItemAtSlot(SlotIndex).Quantity;
+			if (Quantity > 0)
+			{
+				Inventory->RemoveItemFromSlot(SlotIndex, Random.RandRange(1, Quantity));
+			}
+		}
+	};
+
+	RunScenario(ScenarioName(TEXT("SortByItemID")), Iterations, FragmentInventory,
+		[this](int32)
+		{
+			Inventory->SortInventory(EInventorySortMode::ByItemID);
+		});
+
+	RunScenario(ScenarioName(TEXT("SortCompact")), Iterations, FragmentInventory,
+		[this](int32)
+		{
+			Inventory->SortInventory(EInventorySortMode::Compact);
+		});
+
+	// Persistence: full snapshots of a busy bag, and deltas after a few changes
+	FillInventory(NumSlots * 3 / 4);
+	Inventory->AddResource(EResourceType::Wood, 250);
+	Inventory->AddResource(EResourceType::Iron, 40);
+	Inventory->AddResource(EResourceType::Crystal, 3);
+	const FInventoryContents Expected = CaptureContents();
+
+	TArray<uint8> Snapshot;
+	RunScenario(ScenarioName(TEXT("SerializeBinary")), Iterations,
+		[this, &Snapshot](int32)
+		{
+			Inventory->SerializeInventoryBinary(Snapshot);
+		});
+	AddResultMetric(TEXT("EncodedBytes"), Snapshot.Num());
+
+	int32 FailedLoads = 0;
+	RunScenario(ScenarioName(TEXT("DeserializeBinary")), Iterations,
+		[this, &Snapshot, &FailedLoads](int32)
+		{
+			FailedLoads += Inventory->DeserializeInventoryBinary(Snapshot) ? 0 : 1;
+		});
+	ReportRoundTrip(TEXT("Binary"), Expected, FailedLoads);
+
+	// The JSON debug export, for comparison with the binary form on the same bag
+	FString Json;
+	RunScenario(ScenarioName(TEXT("SerializeJson")), Iterations,
+		[this, &Json](int32)
+		{
+			Json = Inventory->SerializeInventory();
+		});
+	AddResultMetric(TEXT("EncodedBytes"), FTCHARToUTF8(*Json).Length());
+
+	FailedLoads = 0;
+	RunScenario(ScenarioName(TEXT("DeserializeJson")), Iterations,
+		[this, &Json, &FailedLoads](int32)
+		{
+			FailedLoads += Inventory->DeserializeInventory(Json) ? 0 : 1;
+		});
+	ReportRoundTrip(TEXT("JSON"), Expected, FailedLoads);
+
+	TArray<uint8> Delta;
+	RunScenario(ScenarioName(TEXT("BuildDelta")), Iterations,
+		[this](int32 Operation)
+		{
+			Inventory->AcknowledgeInventorySnapshot(Inventory->GetSnapshotVersion());
+			const int32 ItemID = GetRandomStackableItemID();
+			if (Operation % 2 == 0 || !Inventory->RemoveItemByID(ItemID, 1))
+			{
+				Inventory->AddItemByID(ItemID, 1);
+			}
+		},
+		[this, &Delta](int32)
+		{
+			Inventory->BuildInventoryDelta(Delta);
+		});
+
+	RunScenario(ScenarioName(TEXT("Clear")), Iterations,
+		[this, NumSlots](int32)
+		{
+			FillInventory(NumSlots * 2 / 3);
+		},
+		[this](int32)
+		{
+			Inventory->ClearInventory();
+		});
+}
+
+void UInventoryBenchmarkCommandlet::RegisterBenchmarkItems()
+{
+	UItemRegistry* Registry = UItemRegistry::Get();
+	check(Registry);
+
+	for (int32 i = 0; i < NumBenchmarkItems; ++i)
+	{
+		UItem* Item = NewObject<UItem>(Registry);
+		Item->ItemID = FirstBenchmarkItemID + i;
+		Item->ItemName = FString::Printf(TEXT("Benchmark Item %d"), i);
+		Item->Weight = 0.1f + (i % 10) * 0.25f;
+		Item->bIsStackable = i < NumBenchmarkItems / 2;
+		Item->MaxStackSize = Item->bIsStackable ? 20 + (i % 4) * 25 : 1;
+		Registry->RegisterItem(Item);
+	}
+}
+
+void UInventoryBenchmarkCommandlet::RunReplicationEstimate()
+{
+	Inventory = NewObject<UInventoryComponent>(GetTransientPackage());
+	Inventory->MaxSlots = ReplicationSlots;
+	Inventory->MaxWeight = 1.0e9f;
+	Inventory->ClearInventory();
+
+	// What the owning client last received, slot by slot
+	TArray<FInventorySlot> SentSlots;
+	SentSlots.SetNum(ReplicationSlots);
+
+	const float LootChance = LootsPerSecond / NetUpdateRate;
+	int64 FullArrayBits = 0;
+	int64 ArrayDeltaBits = 0;
+	int64 FastArrayBits = 0;
+	int64 UpdatesWithChanges = 0;
+	int64 ChangedSlots = 0;
+	int64 FastArrayChanges = 0;
+	int64 FastArrayDeletes = 0;
+	int64 Vendors = 0;
+
+	// One operation is a server frame of looting followed by the net update that replicates it
+	FInventoryTransaction Loot;
+	RunScenario(FString::Printf(TEXT("LootReplication%d"), ReplicationSlots), LootSeconds * NetUpdateRate,
+		[&](int32)
+		{
+			if (Random.GetFraction() < LootChance)
+			{
+				Loot.ItemsToAdd.Reset();
+				for (int32 i = Random.RandRange(1, MaxItemsPerLoot); i > 0; --i)
+				{
+					const int32 ItemID = GetRandomItemID();
+					Loot.ItemsToAdd.Emplace(ItemID, GetBenchmarkQuantity(ItemID, Random, 10));
+				}
+				Inventory->ApplyTransaction(Loot);
+			}
+
+			if (Inventory->GetEmptySlotCount() < VendorFreeSlots)
+			{
+				for (int32 i = 0; i < SlotsSoldPerVendor; ++i)
+				{
+					const int32 SlotIndex = Random.RandRange(0, ReplicationSlots - 1);
+					const int32 Quantity = Inventory->GetItemAtSlot(SlotIndex).Quantity;
+					if (Quantity > 0)
+					{
+						Inventory->RemoveItemFromSlot(SlotIndex, Quantity);
+					}
+				}
+				++Vendors;
+			}
+
+			int32 NumChanged = 0;
+			int32 NumFastArrayChanges = 0;
+			int32 NumFastArrayDeletes = 0;
+			for (int32 SlotIndex = 0; SlotIndex < ReplicationSlots; ++SlotIndex)
+			{
+				const FInventorySlot Slot = Inventory->GetItemAtSlot(SlotIndex);
+				FInventorySlot& Sent = SentSlots[SlotIndex];
+				if (Slot.Quantity == Sent.Quantity && (Slot.IsEmpty() || Slot.HoldsSameItem(Sent)))
+				{
+					continue;
+				}
+
+				// The fast array only holds occupied slots, so emptying one deletes its entry
+				++NumChanged;
+				NumFastArrayChanges += Slot.IsEmpty() ? 0 : 1;
+				NumFastArrayDeletes += Slot.IsEmpty() ? 1 : 0;
+				Sent = Slot;
+			}
+
+			if (NumChanged == 0)
+			{
+				return;
+			}
+
+			// A plain replicated array resent whole, as the request assumed; the rep layout can instead send only the
+			// elements that differ from the connection's shadow copy, after comparing every slot each update
+			FullArrayBits += SubobjectHeaderBits + HandleBits + ArrayNumBits + ReplicationSlots * (HandleBits + SlotBits) + HandleBits + HandleBits;
+			ArrayDeltaBits += SubobjectHeaderBits + HandleBits + ArrayNumBits + NumChanged * (HandleBits + SlotBits) + HandleBits + HandleBits;
+			FastArrayBits += SubobjectHeaderBits + HandleBits + FastArrayHeaderBits
+				+ NumFastArrayDeletes * FastArrayIDBits + NumFastArrayChanges * (FastArrayIDBits + FastArrayItemBits) + HandleBits;
+
+			++UpdatesWithChanges;
+			ChangedSlots += NumChanged;
+			FastArrayChanges += NumFastArrayChanges;
+			FastArrayDeletes += NumFastArrayDeletes;
+		});
+
+	// Owner-only relevancy, so each figure is both the server's cost per looting player and the owner's inbound
+	const double Seconds = LootSeconds;
+	AddResultMetric(TEXT("FullArrayKbps"), FullArrayBits / 1000.0 / Seconds);
+	AddResultMetric(TEXT("ArrayDeltaKbps"), ArrayDeltaBits / 1000.0 / Seconds);
+	AddResultMetric(TEXT("FastArrayKbps"), FastArrayBits / 1000.0 / Seconds);
+	AddResultMetric(TEXT("SavedVsFullArrayPct"), FullArrayBits > 0 ? 100.0 * (1.0 - static_cast<double>(FastArrayBits) / FullArrayBits) : 0.0);
+	AddResultMetric(TEXT("ArraySlotComparisonsPerUpdate"), ReplicationSlots);
+	AddResultMetric(TEXT("FastArrayDirtyEntriesPerUpdate"), static_cast<double>(FastArrayChanges + FastArrayDeletes) / (LootSeconds * NetUpdateRate));
+	AddResultMetric(TEXT("UpdatesWithChangesPerSec"), UpdatesWithChanges / Seconds);
+	AddResultMetric(TEXT("SlotChangesPerSec"), ChangedSlots / Seconds);
+	AddResultMetric(TEXT("VendorsPerMin"), Vendors * 60.0 / Seconds);
+}
+
+void UInventoryBenchmarkCommandlet::RunPlayerInventories(const TCHAR* Layout, bool bUniqueInstances)
+{
+	// Start from a clean heap so earlier scenarios' garbage is neither measured nor collected here
+	Inventory = nullptr;
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	const int32 ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	PlayerInventories.Reset(NumPlayers);
+	RunScenario(FString::Printf(TEXT("Load%s%d"), Layout, NumPlayers), NumPlayers,
+		[this, bUniqueInstances](int32)
+		{
+			UInventoryComponent* PlayerInventory = NewObject<UInventoryComponent>(GetTransientPackage());
+			PlayerInventory->MaxSlots = PlayerBagSlots;
+			PlayerInventory->MaxWeight = 1.0e9f;
+			PlayerInventory->ClearInventory();
+			PlayerInventories.Add(PlayerInventory);
+
+			for (int32 i = 0; i < PlayerBagAdds && !PlayerInventory->IsFull(); ++i)
+			{
+				const int32 ItemID = GetRandomItemID();
+				if (!bUniqueInstances)
+				{
+					PlayerInventory->AddItemByID(ItemID, GetBenchmarkQuantity(ItemID, Random, 30));
+					continue;
+				}
+
+				// An object per slot; not being the registered definition makes it a unique instance
+				UItem* Item = NewObject<UItem>(PlayerInventory);
+				Item->ItemID = ItemID;
+				Item->Weight = 1.0f;
+				PlayerInventory->AddItem(Item, 1);
+			}
+		});
+
+	const FBenchmarkResult& Load = GetLastResult();
+	AddResultMetric(TEXT("BytesPerPlayer"), static_cast<double>(Load.PeakLiveBytes) / NumPlayers);
+	AddResultMetric(TEXT("TotalMB"), Load.PeakLiveBytes / (1024.0 * 1024.0));
+	AddResultMetric(TEXT("ObjectsPerPlayer"), static_cast<double>(GUObjectArray.GetObjectArrayNumMinusAvailable() - ObjectsBefore) / NumPlayers);
+
+	// Everything is reachable, so each pass measures the mark phase over every loaded bag
+	RunScenario(FString::Printf(TEXT("CollectGarbage%s%d"), Layout, NumPlayers), GarbageCollections,
+		[](int32)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		});
+	AddResultMetric(TEXT("MsPerCollection"), GetLastResult().TotalSeconds * 1000.0 / GarbageCollections);
+
+	PlayerInventories.Reset();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+}
+
+UInventoryBenchmarkCommandlet::FInventoryContents UInventoryBenchmarkCommandlet::CaptureContents() const
+{
+	FInventoryContents Contents;
+	Contents.Slots.Reserve(Inventory->MaxSlots);
+	for (int32 i = 0; i < Inventory->MaxSlots; ++i)
+	{
+		Contents.Slots.Add(Inventory->GetItemAtSlot(i));
+	}
+	Contents.Resources = Inventory->GetAllResources();
+	return Contents;
+}
+
+void UInventoryBenchmarkCommandlet::ReportRoundTrip(const TCHAR* Format, const FInventoryContents& Expected, int32 FailedLoads)
+{
+	// Every load replaces the whole bag, so the bag left by the last one shows whether the data survived
+	const FInventoryContents Loaded = CaptureContents();
+	int32 MismatchedSlots = 0;
+	for (int32 i = 0; i < Expected.Slots.Num(); ++i)
+	{
+		const FInventorySlot& Slot = Loaded.Slots[i];
+		if (Slot.Quantity != Expected.Slots[i].Quantity || (!Slot.IsEmpty() && !Slot.HoldsSameItem(Expected.Slots[i])))
+		{
+			++MismatchedSlots;
+		}
+	}
+
+	int32 MismatchedResources = 0;
+	for (int32 Type = 0; Type < NumResourceTypes; ++Type)
+	{
+		const EResourceType ResourceType = static_cast<EResourceType>(Type);
+		if (Loaded.Resources.FindRef(ResourceType) != Expected.Resources.FindRef(ResourceType))
+		{
+			++MismatchedResources;
+		}
+	}
+
+	const int32 RoundTripErrors = FailedLoads + MismatchedSlots + MismatchedResources;
+	if (RoundTripErrors > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s round trip of a %d-slot bag: %d failed loads, %d mismatched slots, %d mismatched resources"),
+			Format, Expected.Slots.Num(), FailedLoads, MismatchedSlots, MismatchedResources);
+	}
+	AddResultMetric(TEXT("RoundTripErrors"), RoundTripErrors);
+}
+
+void UInventoryBenchmarkCommandlet::FillInventory(int32 NumAdds)
+{
+	Inventory->ClearInventory();
+	for (int32 i = 0; i < NumAdds && !Inventory->IsFull(); ++i)
+	{
+		const int32 ItemID = GetRandomItemID();
+		Inventory->AddItemByID(ItemID, GetBenchmarkQuantity(ItemID, Random, 30));
+	}
+}
+
+int32 UInventoryBenchmarkCommandlet::GetRandomItemID()
+{
+	return FirstBenchmarkItemID + Random.RandRange(0, NumBenchmarkItems - 1);
+}
+
+int32 UInventoryBenchmarkCommandlet::GetRandomStackableItemID()
+{
+	return FirstBenchmarkItemID + Random.RandRange(0, NumBenchmarkItems / 2 - 1);
+}
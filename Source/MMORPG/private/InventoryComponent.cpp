@@ -2,73 +2,282 @@
 
 #include "InventoryComponent.h"
 #include "EquipmentItem.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "ItemRegistry.h"
+#include "GameFramework/Actor.h"
+#include "Misc/Base64.h"
+#include "Net/UnrealNetwork.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	// Bump when the binary inventory layouts change; other versions are rejected rather than misread
+	// Slots are stored by ItemID; unique instances are tagged and followed by their class and properties
+	constexpr uint8 InventoryBinaryVersion = 3;
+	constexpr uint8 InventoryDeltaVersion = 2;
+
+	// A slot's quantity is written shifted up one bit, with the low bit tagging a unique instance
+	uint32 PackSlotQuantity(const FInventorySlot& Slot)
+	{
+		return Slot.IsEmpty() ? 0 : (static_cast<uint32>(Slot.Quantity) << 1) | (Slot.Instance ? 1 : 0);
+	}
+
+	// A unique instance's payload is its class path and tagged properties, so its own state survives
+	void SaveItemInstance(const UItem* Instance, TArray<uint8>& OutPayload)
+	{
+		OutPayload.Reset();
+		FMemoryWriter MemoryWriter(OutPayload, true);
+		FObjectAndNameAsStringProxyArchive Writer(MemoryWriter, false);
+		FString ClassPath = Instance->GetClass()->GetPathName();
+		Writer << ClassPath;
+		Instance->SerializeScriptProperties(Writer);
+	}
+
+	// Replicated entries carry the same payload; stacks leave it empty
+	void SetReplicatedInstance(FReplicatedInventorySlot& Entry, const UItem* Instance)
+	{
+		if (Instance)
+		{
+			SaveItemInstance(Instance, Entry.InstanceData);
+		}
+		else
+		{
+			Entry.InstanceData.Reset();
+		}
+	}
+
+	// Create the instance a payload describes; nullptr if the payload is malformed or names no item class
+	UItem* LoadItemInstance(UObject* Outer, const TArray<uint8>& Payload)
+	{
+		FMemoryReader MemoryReader(Payload, true);
+		FObjectAndNameAsStringProxyArchive Reader(MemoryReader, true);
+		FString ClassPath;
+		Reader << ClassPath;
+		if (Reader.IsError())
+		{
+			return nullptr;
+		}
+
+		UClass* ItemClass = FSoftClassPath(ClassPath).TryLoadClass<UItem>();
+		if (!ItemClass || ItemClass->HasAnyClassFlags(CLASS_Abstract))
+		{
+			return nullptr;
+		}
+
+		UItem* Instance = NewObject<UItem>(Outer, ItemClass);
+		Instance->SerializeScriptProperties(Reader);
+		return Reader.IsError() ? nullptr : Instance;
+	}
+
+	// Payloads are length-prefixed in the binary formats
+	void WriteItemInstance(FArchive& Writer, const UItem* Instance)
+	{
+		TArray<uint8> Payload;
+		SaveItemInstance(Instance, Payload);
+		uint32 PayloadSize = Payload.Num();
+		Writer.SerializeIntPacked(PayloadSize);
+		Writer.Serialize(Payload.GetData(), Payload.Num());
+	}
+
+	UItem* ReadItemInstance(FArchive& Reader, UObject* Outer)
+	{
+		uint32 PayloadSize = 0;
+		Reader.SerializeIntPacked(PayloadSize);
+		if (Reader.IsError() || PayloadSize == 0 || PayloadSize > static_cast<uint64>(Reader.TotalSize() - Reader.Tell()))
+		{
+			return nullptr;
+		}
+
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(PayloadSize);
+		Reader.Serialize(Payload.GetData(), PayloadSize);
+		return Reader.IsError() ? nullptr : LoadItemInstance(Outer, Payload);
+	}
+
+	// Insert into an ascending array of slot indices
+	void InsertSorted(TArray<int32>& SortedSlots, int32 SlotIndex)
+	{
+		SortedSlots.Insert(SlotIndex, Algo::LowerBound(SortedSlots, SlotIndex));
+	}
+
+	// Remove from an ascending array of slot indices
+	void RemoveSorted(TArray<int32>& SortedSlots, int32 SlotIndex)
+	{
+		const int32 Position = Algo::BinarySearch(SortedSlots, SlotIndex);
+		if (Position != INDEX_NONE)
+		{
+			SortedSlots.RemoveAt(Position, 1, false);
+		}
+	}
+
+	// Resource types that can be held; None and out-of-range values are rejected
+	bool IsHeldResourceType(EResourceType ResourceType)
+	{
+		return ResourceType != EResourceType::None && static_cast<int32>(ResourceType) < NumResourceTypes;
+	}
+
+	// Sum entries per item in first-seen order; rejects entries naming no item and non-positive quantities
+	bool AggregateByItem(const TArray<FInventoryItemAmount>& Entries, TArray<FInventoryItemAmount>& OutTotals)
+	{
+		for (const FInventoryItemAmount& Entry : Entries)
+		{
+			if ((Entry.ItemID == INDEX_NONE && !Entry.Instance) || Entry.Quantity <= 0)
+			{
+				return false;
+			}
+
+			// A unique instance is identified by the object, a stack by its ItemID
+			FInventoryItemAmount* Total = OutTotals.FindByPredicate([&Entry](const FInventoryItemAmount& Candidate)
+			{
+				return Candidate.Instance == Entry.Instance && (Entry.Instance || Candidate.ItemID == Entry.ItemID);
+			});
+
+			if (Total)
+			{
+				Total->Quantity += Entry.Quantity;
+			}
+			else
+			{
+				FInventoryItemAmount& Added = OutTotals.Add_GetRef(Entry);
+				if (Added.Instance)
+				{
+					Added.ItemID = Added.Instance->ItemID;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+void FReplicatedInventorySlot::PreReplicatedRemove(const FReplicatedInventorySlotArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleReplicatedSlot(*this, EInventorySlotReplication::Removed);
+	}
+}
+
+void FReplicatedInventorySlot::PostReplicatedAdd(const FReplicatedInventorySlotArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleReplicatedSlot(*this, EInventorySlotReplication::Added);
+	}
+}
+
+void FReplicatedInventorySlot::PostReplicatedChange(const FReplicatedInventorySlotArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleReplicatedSlot(*this, EInventorySlotReplication::Changed);
+	}
+}
+
+void FReplicatedInventorySlotArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (Owner)
+	{
+		Owner->FlushReplicatedSlots();
+	}
+}
 
 UInventoryComponent::UInventoryComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedComponent(true);
 	MaxSlots = 30;
 	MaxWeight = 100.0f;
 	CurrentWeight = 0.0f;
+	ReplicatedSlots.Owner = this;
 }
 
 void UInventoryComponent::BeginPlay()
 {
 	Super::BeginPlay();
-}
 
-bool UInventoryComponent::AddResource(EResourceType ResourceType, int32 Quantity)
-{
-	if (ResourceType == EResourceType::None || Quantity <= 0)
-	
 	// Initialize inventory slots
 	InventorySlots.SetNum(MaxSlots);
+	RebuildSlotIndex();
 }
 
-bool UInventoryComponent::AddItem(UItem* Item, int32 Quantity)
+void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	if (!Item || Quantity <= 0)
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(UInventoryComponent, ReplicatedSlots, COND_OwnerOnly);
+}
+
+void UInventoryComponent::HandleReplicatedSlot(const FReplicatedInventorySlot& Entry, EInventorySlotReplication Change)
+{
+	// Initial replication can arrive before BeginPlay has sized the bag
+	if (InventorySlots.Num() < MaxSlots)
 	{
-		return false;
+		InventorySlots.SetNum(MaxSlots);
+		RebuildSlotIndex();
 	}
 
-	// Check if we already have this resource
-	if (ResourceInventory.Contains(ResourceType))
+	if (!InventorySlots.IsValidIndex(Entry.SlotIndex))
 	{
-		int32 CurrentQuantity = ResourceInventory[ResourceType];
-		
-		// Check max stack size if applicable
-		if (MaxStackSize > 0)
+		return;
+	}
+
+	FInventorySlot NewContents;
+	if (Change != EInventorySlotReplication::Removed)
+	{
+		if (Entry.InstanceData.Num() > 0)
 		{
-			int32 SpaceAvailable = MaxStackSize - CurrentQuantity;
-			if (SpaceAvailable <= 0)
+			if (UItem* Instance = LoadItemInstance(this, Entry.InstanceData))
 			{
-				return false;
+				NewContents = FInventorySlot(Instance->ItemID, 1, Instance);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s: replicated instance of item %d could not be loaded, slot %d left empty"),
+					*GetName(), Entry.ItemID, Entry.SlotIndex);
 			}
-			
-			// Add only what fits
-			int32 AmountToAdd = FMath::Min(Quantity, SpaceAvailable);
-			ResourceInventory[ResourceType] = CurrentQuantity + AmountToAdd;
-		}
-		else
-		{
-			// No stack limit, add full amount
-			ResourceInventory[ResourceType] = CurrentQuantity + Quantity;
 		}
-	}
-	else
-	{
-		// New resource type
-		if (MaxStackSize > 0)
+		else if (IsKnownItemID(Entry.ItemID))
 		{
-			int32 AmountToAdd = FMath::Min(Quantity, MaxStackSize);
-			ResourceInventory.Add(ResourceType, AmountToAdd);
+			NewContents = FInventorySlot(Entry.ItemID, Entry.Quantity);
 		}
 		else
 		{
-			ResourceInventory.Add(ResourceType, Quantity);
+			UE_LOG(LogTemp, Warning, TEXT("%s: replicated item %d is not registered, slot %d left empty"),
+				*GetName(), Entry.ItemID, Entry.SlotIndex);
 		}
 	}
 
+	SetSlotContents(Entry.SlotIndex, NewContents);
+	PendingReplicatedSlots.Add(Entry.SlotIndex);
+	OnSlotReplicated.Broadcast(this, Entry.SlotIndex, Change);
+}
+
+void UInventoryComponent::FlushReplicatedSlots()
+{
+	if (PendingReplicatedSlots.Num() == 0)
+	{
+		return;
+	}
+
+	checkSlow(IsAccountingConsistent());
+	BroadcastSlotsChanged(PendingReplicatedSlots);
+	PendingReplicatedSlots.Reset();
+}
+
+bool UInventoryComponent::AddResource(EResourceType ResourceType, int32 Quantity)
+{
+	if (!AddResourceQuantity(ResourceType, Quantity))
+	{
+		return false;
+	}
+
+	MarkResourcesDirty();
 	return true;
 }
 
@@ -79,93 +288,155 @@ bool UInventoryComponent::AddResourceItem(const FResourceItem& ResourceItem)
 
 int32 UInventoryComponent::RemoveResource(EResourceType ResourceType, int32 Quantity)
 {
-	if (!ResourceInventory.Contains(ResourceType) || Quantity <= 0)
+	if (!IsHeldResourceType(ResourceType) || Quantity <= 0)
 	{
 		return 0;
 	}
 
-	int32 CurrentQuantity = ResourceInventory[ResourceType];
+	int32& CurrentQuantity = ResourceCounts[ResourceType];
 	int32 AmountToRemove = FMath::Min(Quantity, CurrentQuantity);
-
-	ResourceInventory[ResourceType] = CurrentQuantity - AmountToRemove;
-
-	// Remove entry if quantity is now zero
-	if (ResourceInventory[ResourceType] <= 0)
+	if (AmountToRemove <= 0)
 	{
-		ResourceInventory.Remove(ResourceType);
+		return 0;
 	}
 
+	CurrentQuantity -= AmountToRemove;
+	MarkResourcesDirty();
 	return AmountToRemove;
 }
 
 int32 UInventoryComponent::GetResourceQuantity(EResourceType ResourceType) const
 {
-	if (ResourceInventory.Contains(ResourceType))
-	{
-		return ResourceInventory[ResourceType];
-	}
-	return 0;
+	return IsHeldResourceType(ResourceType) ? ResourceCounts[ResourceType] : 0;
 }
 
 bool UInventoryComponent::HasResource(EResourceType ResourceType, int32 MinQuantity) const
 {
 	return GetResourceQuantity(ResourceType) >= MinQuantity;
-	// Check if adding this item would exceed weight limit
-	float ItemWeight = Item->Weight * Quantity;
-	if (CurrentWeight + ItemWeight > MaxWeight)
+}
+
+TMap<EResourceType, int32> UInventoryComponent::GetAllResources() const
+{
+	TMap<EResourceType, int32> Resources;
+	Resources.Reserve(ResourceCounts.NumNonZero());
+	for (int32 i = 0; i < NumResourceTypes; ++i)
+	{
+		if (ResourceCounts.Counts[i] != 0)
+		{
+			Resources.Add(static_cast<EResourceType>(i), ResourceCounts.Counts[i]);
+		}
+	}
+	return Resources;
+}
+
+bool UInventoryComponent::AddResources(const TArray<FResourceItem>& Resources)
+{
+	bool bAllAdded = Resources.Num() > 0;
+	bool bAnyAdded = false;
+	for (const FResourceItem& Resource : Resources)
+	{
+		const bool bAdded = AddResourceQuantity(Resource.ResourceType, Resource.Quantity);
+		bAllAdded &= bAdded;
+		bAnyAdded |= bAdded;
+	}
+
+	// One dirty mark for the whole batch
+	if (bAnyAdded)
+	{
+		MarkResourcesDirty();
+	}
+	return bAllAdded;
+}
+
+bool UInventoryComponent::RemoveResources(const TArray<FResourceItem>& Resources)
+{
+	if (Resources.Num() == 0 || !HasResources(Resources))
 	{
 		return false;
 	}
 
-	int32 RemainingQuantity = Quantity;
+	for (const FResourceItem& Resource : Resources)
+	{
+		ResourceCounts[Resource.ResourceType] -= Resource.Quantity;
+	}
+
+	MarkResourcesDirty();
+	return true;
+}
 
-	// If item is stackable, try to stack it with existing items
-	if (Item->bIsStackable)
+bool UInventoryComponent::HasResources(const TArray<FResourceItem>& Resources) const
+{
+	// Sum repeated types first so two entries can't each be satisfied by the same stock
+	FResourceCounts Required;
+	for (const FResourceItem& Resource : Resources)
 	{
-		int32 StackableSlot = FindStackableSlot(Item);
-		while (StackableSlot != -1 && RemainingQuantity > 0)
+		if (!IsHeldResourceType(Resource.ResourceType) || Resource.Quantity <= 0)
 		{
-			FInventorySlot& Slot = InventorySlots[StackableSlot];
-			int32 AvailableSpace = Item->MaxStackSize - Slot.Quantity;
-			int32 AmountToAdd = FMath::Min(RemainingQuantity, AvailableSpace);
-			
-			Slot.Quantity += AmountToAdd;
-			RemainingQuantity -= AmountToAdd;
-
-			if (RemainingQuantity > 0)
-			{
-				StackableSlot = FindStackableSlot(Item);
-			}
-			else
-			{
-				break;
-			}
+			return false;
 		}
+		Required[Resource.ResourceType] += Resource.Quantity;
 	}
 
-	// Add remaining items to empty slots
-	while (RemainingQuantity > 0)
+	for (int32 i = 0; i < NumResourceTypes; ++i)
 	{
-		int32 EmptySlot = FindEmptySlot();
-		if (EmptySlot == -1)
+		if (ResourceCounts.Counts[i] < Required.Counts[i])
 		{
-			// Inventory full, return false
 			return false;
 		}
+	}
+	return true;
+}
 
-		int32 AmountToAdd = Item->bIsStackable ? FMath::Min(RemainingQuantity, Item->MaxStackSize) : 1;
-		InventorySlots[EmptySlot] = FInventorySlot(Item, AmountToAdd);
-		RemainingQuantity -= AmountToAdd;
+TArray<int32> UInventoryComponent::GetResourceQuantities(const TArray<EResourceType>& ResourceTypes) const
+{
+	TArray<int32> Quantities;
+	Quantities.Reserve(ResourceTypes.Num());
+	for (EResourceType ResourceType : ResourceTypes)
+	{
+		Quantities.Add(GetResourceQuantity(ResourceType));
+	}
+	return Quantities;
+}
 
-		if (!Item->bIsStackable)
+bool UInventoryComponent::AddResourceQuantity(EResourceType ResourceType, int32 Quantity)
+{
+	if (!IsHeldResourceType(ResourceType) || Quantity <= 0)
+	{
+		return false;
+	}
+
+	int32& CurrentQuantity = ResourceCounts[ResourceType];
+
+	// Check max stack size if applicable
+	if (MaxStackSize > 0)
+	{
+		int32 SpaceAvailable = MaxStackSize - CurrentQuantity;
+		if (SpaceAvailable <= 0)
 		{
-			break;
+			return false;
 		}
+
+		// Add only what fits
+		CurrentQuantity += FMath::Min(Quantity, SpaceAvailable);
+	}
+	else
+	{
+		// No stack limit, add full amount
+		CurrentQuantity += Quantity;
 	}
+	return true;
+}
 
-	UpdateWeight();
-	OnInventoryChanged.Broadcast(this);
-	return RemainingQuantity == 0;
+bool UInventoryComponent::AddItem(UItem* Item, int32 Quantity)
+{
+	if (!Item || Quantity <= 0)
+	{
+		return false;
+	}
+
+	FInventoryTransaction Transaction;
+	Transaction.ItemsToAdd.Add(MakeItemAmount(Item, Quantity));
+	return ApplyTransaction(Transaction);
 }
 
 bool UInventoryComponent::RemoveItem(UItem* Item, int32 Quantity)
@@ -175,31 +446,33 @@ bool UInventoryComponent::RemoveItem(UItem* Item, int32 Quantity)
 		return false;
 	}
 
-	if (!HasItem(Item, Quantity))
+	FInventoryTransaction Transaction;
+	Transaction.ItemsToRemove.Add(MakeItemAmount(Item, Quantity));
+	return ApplyTransaction(Transaction);
+}
+
+bool UInventoryComponent::AddItemByID(int32 ItemID, int32 Quantity)
+{
+	if (Quantity <= 0)
 	{
 		return false;
 	}
 
-	int32 RemainingQuantity = Quantity;
+	FInventoryTransaction Transaction;
+	Transaction.ItemsToAdd.Emplace(ItemID, Quantity);
+	return ApplyTransaction(Transaction);
+}
 
-	for (int32 i = 0; i < InventorySlots.Num() && RemainingQuantity > 0; ++i)
+bool UInventoryComponent::RemoveItemByID(int32 ItemID, int32 Quantity)
+{
+	if (Quantity <= 0)
 	{
-		if (InventorySlots[i].Item == Item)
-		{
-			int32 AmountToRemove = FMath::Min(RemainingQuantity, InventorySlots[i].Quantity);
-			InventorySlots[i].Quantity -= AmountToRemove;
-			RemainingQuantity -= AmountToRemove;
-
-			if (InventorySlots[i].Quantity <= 0)
-			{
-				InventorySlots[i] = FInventorySlot();
-			}
-		}
+		return false;
 	}
 
-	UpdateWeight();
-	OnInventoryChanged.Broadcast(this);
-	return true;
+	FInventoryTransaction Transaction;
+	Transaction.ItemsToRemove.Emplace(ItemID, Quantity);
+	return ApplyTransaction(Transaction);
 }
 
 bool UInventoryComponent::RemoveItemFromSlot(int32 SlotIndex, int32 Quantity)
@@ -209,23 +482,53 @@ bool UInventoryComponent::RemoveItemFromSlot(int32 SlotIndex, int32 Quantity)
 		return false;
 	}
 
-	FInventorySlot& Slot = InventorySlots[SlotIndex];
-	if (!Slot.Item || Slot.Quantity < Quantity)
+	FInventorySlot NewContents = InventorySlots[SlotIndex];
+	if (NewContents.IsEmpty() || NewContents.Quantity < Quantity)
+	{
+		return false;
+	}
+
+	NewContents.Quantity -= Quantity;
+	SetSlotContents(SlotIndex, NewContents);
+
+	checkSlow(IsAccountingConsistent());
+	TArray<int32> ChangedSlots = { SlotIndex };
+	BroadcastSlotsChanged(ChangedSlots);
+	return true;
+}
+
+bool UInventoryComponent::ApplyTransaction(const FInventoryTransaction& Transaction)
+{
+	TArray<FInventoryItemAmount> Removes;
+	TArray<FInventoryItemAmount> Adds;
+	if (!PlanTransaction(Transaction, Removes, Adds))
 	{
 		return false;
 	}
 
-	Slot.Quantity -= Quantity;
-	if (Slot.Quantity <= 0)
+	// The plan has validated every remove and reserved room for every add, so nothing below can fail
+	TArray<int32> ChangedSlots;
+	for (const FInventoryItemAmount& Remove : Removes)
+	{
+		RemoveFromSlots(Remove, ChangedSlots);
+	}
+	for (const FInventoryItemAmount& Add : Adds)
 	{
-		Slot = FInventorySlot();
+		AddToSlots(Add, ChangedSlots);
 	}
 
-	UpdateWeight();
-	OnInventoryChanged.Broadcast(this);
+	checkSlow(IsAccountingConsistent());
+	BroadcastSlotsChanged(ChangedSlots);
 	return true;
 }
 
+bool UInventoryComponent::CanApplyTransaction(const FInventoryTransaction& Transaction) const
+{
+	TArray<FInventoryItemAmount> Removes;
+	TArray<FInventoryItemAmount> Adds;
+	return PlanTransaction(Transaction, Removes, Adds);
+}
+
 FInventorySlot UInventoryComponent::GetItemAtSlot(int32 SlotIndex) const
 {
 	if (SlotIndex >= 0 && SlotIndex < InventorySlots.Num())
@@ -235,16 +538,40 @@ FInventorySlot UInventoryComponent::GetItemAtSlot(int32 SlotIndex) const
 	return FInventorySlot();
 }
 
+UItem* UInventoryComponent::GetSlotItem(int32 SlotIndex) const
+{
+	if (!InventorySlots.IsValidIndex(SlotIndex) || InventorySlots[SlotIndex].IsEmpty())
+	{
+		return nullptr;
+	}
+
+	const FInventorySlot& Slot = InventorySlots[SlotIndex];
+	if (Slot.Instance)
+	{
+		return Slot.Instance;
+	}
+
+	UItemRegistry* Registry = UItemRegistry::Get();
+	return Registry ? Registry->FindItemByID(Slot.ItemID) : nullptr;
+}
+
 int32 UInventoryComponent::FindItem(UItem* Item) const
 {
-	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	if (!Item)
 	{
-		if (InventorySlots[i].Item == Item)
-		{
-			return i;
-		}
+		// Null matches the first empty slot, as the linear scan used to
+		return FindEmptySlot();
+	}
+
+	const FInventoryItemAmount Amount = MakeItemAmount(Item, 1);
+	if (Amount.Instance)
+	{
+		const int32* SlotIndex = InstanceSlotIndex.Find(Amount.Instance);
+		return SlotIndex ? *SlotIndex : -1;
 	}
-	return -1;
+
+	const FInventoryItemSlots* Entry = ItemSlotIndex.Find(Amount.ItemID);
+	return Entry ? Entry->Slots[0] : -1;
 }
 
 bool UInventoryComponent::HasItem(UItem* Item, int32 Quantity) const
@@ -254,52 +581,140 @@ bool UInventoryComponent::HasItem(UItem* Item, int32 Quantity) const
 
 int32 UInventoryComponent::GetItemQuantity(UItem* Item) const
 {
-	int32 TotalQuantity = 0;
-	for (const FInventorySlot& Slot : InventorySlots)
+	if (!Item)
 	{
-		if (Slot.Item == Item)
-		{
-			TotalQuantity += Slot.Quantity;
-		}
+		return 0;
+	}
+
+	const FInventoryItemAmount Amount = MakeItemAmount(Item, 1);
+	if (Amount.Instance)
+	{
+		return InstanceSlotIndex.Contains(Amount.Instance) ? 1 : 0;
 	}
-	return TotalQuantity;
+	return GetItemQuantityByID(Amount.ItemID);
+}
+
+int32 UInventoryComponent::GetItemQuantityByID(int32 ItemID) const
+{
+	const FInventoryItemSlots* Entry = ItemSlotIndex.Find(ItemID);
+	return Entry ? Entry->TotalQuantity : 0;
 }
 
-void UInventoryComponent::SortInventory()
+void UInventoryComponent::SortInventory(EInventorySortMode Mode)
 {
-	// Sort by item ID, then by quantity
-	InventorySlots.Sort([](const FInventorySlot& A, const FInventorySlot& B)
+	// Keys are built once so the sort compares integers instead of reading slots
+	// Order: ItemID, stacks before unique instances, larger quantity first
+	struct FSlotSortKey
 	{
-		if (!A.Item && B.Item) return false;
-		if (A.Item && !B.Item) return true;
-		if (!A.Item && !B.Item) return false;
+		uint64 Key;
+		int32 SlotIndex;
+	};
 
-		if (A.Item->ItemID != B.Item->ItemID)
+	TArray<FSlotSortKey> SortKeys;
+	SortKeys.Reserve(InventorySlots.Num() - FreeSlotHeap.Num());
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	{
+		const FInventorySlot& Slot = InventorySlots[i];
+		if (!Slot.IsEmpty())
 		{
-			return A.Item->ItemID < B.Item->ItemID;
+			const uint64 OrderedItemID = static_cast<uint32>(Slot.ItemID) ^ 0x80000000u;
+			const uint64 InstanceBit = Slot.Instance ? 1 : 0;
+			const uint64 InvertedQuantity = static_cast<uint32>(MAX_int32 - Slot.Quantity);
+			SortKeys.Add({ (OrderedItemID << 32) | (InstanceBit << 31) | InvertedQuantity, i });
 		}
-		return A.Quantity > B.Quantity;
+	}
+
+	Algo::Sort(SortKeys, [](const FSlotSortKey& A, const FSlotSortKey& B)
+	{
+		return A.Key != B.Key ? A.Key < B.Key : A.SlotIndex < B.SlotIndex;
 	});
 
-	OnInventoryChanged.Broadcast(this);
-}
+	// One pass writes the sorted slots from the front, pouring each stack into the previous one when merging
+	const bool bMergeStacks = Mode == EInventorySortMode::Compact;
+	TArray<FInventorySlot> NewSlots;
+	NewSlots.SetNum(InventorySlots.Num());
+	TArray<int32> NewSlotForOldSlot;
+	NewSlotForOldSlot.Init(INDEX_NONE, InventorySlots.Num());
 
-int32 UInventoryComponent::GetEmptySlotCount() const
-{
-	int32 Count = 0;
-	for (const FInventorySlot& Slot : InventorySlots)
+	int32 LastWritten = INDEX_NONE;
+	for (const FSlotSortKey& SortKey : SortKeys)
+	{
+		const FInventorySlot& Slot = InventorySlots[SortKey.SlotIndex];
+		int32 RemainingQuantity = Slot.Quantity;
+
+		if (bMergeStacks && !Slot.Instance && LastWritten != INDEX_NONE && NewSlots[LastWritten].HoldsSameItem(Slot))
+		{
+			const int32 StackLimit = ItemSlotIndex.FindChecked(Slot.ItemID).StackLimit;
+			const int32 AmountToMerge = FMath::Min(RemainingQuantity, StackLimit - NewSlots[LastWritten].Quantity);
+			if (AmountToMerge > 0)
+			{
+				NewSlots[LastWritten].Quantity += AmountToMerge;
+				RemainingQuantity -= AmountToMerge;
+				NewSlotForOldSlot[SortKey.SlotIndex] = LastWritten;
+			}
+		}
+
+		if (RemainingQuantity > 0)
+		{
+			NewSlots[++LastWritten] = FInventorySlot(Slot.ItemID, RemainingQuantity, Slot.Instance);
+			if (NewSlotForOldSlot[SortKey.SlotIndex] == INDEX_NONE)
+			{
+				NewSlotForOldSlot[SortKey.SlotIndex] = LastWritten;
+			}
+		}
+	}
+
+	TArray<int32> ChangedSlots;
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
 	{
-		if (!Slot.Item)
+		if (NewSlots[i].Quantity != InventorySlots[i].Quantity || !NewSlots[i].HoldsSameItem(InventorySlots[i]))
 		{
-			++Count;
+			ChangedSlots.Add(i);
 		}
 	}
-	return Count;
+
+	if (ChangedSlots.Num() == 0)
+	{
+		return;
+	}
+
+	// Totals and weight are unchanged, so only the slot positions need reindexing
+	InventorySlots = MoveTemp(NewSlots);
+	RebuildItemIndices();
+	UpdateWeight();
+	for (int32 SlotIndex : ChangedSlots)
+	{
+		MarkSlotDirty(SlotIndex);
+		UpdateReplicatedSlot(SlotIndex);
+	}
+
+	checkSlow(IsAccountingConsistent());
+	OnInventorySorted.Broadcast(this, NewSlotForOldSlot);
+
+	// Only a remote owner needs the permutation sent; a local one already saw the broadcast
+	const AActor* Owner = GetOwner();
+	if (Owner && Owner->HasAuthority() && Owner->GetNetConnection())
+	{
+		ClientInventorySorted(NewSlotForOldSlot);
+	}
+
+	BroadcastSlotsChanged(ChangedSlots);
+}
+
+void UInventoryComponent::ClientInventorySorted_Implementation(const TArray<int32>& NewSlotForOldSlot)
+{
+	OnInventorySorted.Broadcast(this, NewSlotForOldSlot);
+}
+
+int32 UInventoryComponent::GetEmptySlotCount() const
+{
+	// Every empty slot sits in the free heap
+	return FreeSlotHeap.Num();
 }
 
 bool UInventoryComponent::IsFull() const
 {
-	return GetEmptySlotCount() == 0;
+	return FreeSlotHeap.Num() == 0;
 }
 
 float UInventoryComponent::GetCurrentWeight() const
@@ -309,19 +724,28 @@ float UInventoryComponent::GetCurrentWeight() const
 
 void UInventoryComponent::ClearInventory()
 {
-	ResourceInventory.Empty();
+	ResourceCounts = FResourceCounts();
 	InventorySlots.Empty();
 	InventorySlots.SetNum(MaxSlots);
-	CurrentWeight = 0.0f;
-	OnInventoryChanged.Broadcast(this);
+	RebuildSlotIndex();
+	MarkAllSlotsDirty();
+	MarkResourcesDirty();
+	BroadcastAllSlotsChanged();
 }
 
 void UInventoryComponent::SaveInventoryState()
 {
 	// Stub for future SpacetimeDB integration
-	// This would serialize the inventory and send it to SpacetimeDB
-	FString SerializedData = SerializeInventory();
-	// TODO: Send to SpacetimeDB when integrated
+	// This would send only the slots changed since the last confirmed write to SpacetimeDB
+	if (DirtySlots.Num() == 0 && ResourcesDirtyVersion == 0)
+	{
+		return;
+	}
+
+	TArray<uint8> SerializedDelta;
+	BuildInventoryDelta(SerializedDelta);
+	// TODO: Send to SpacetimeDB when integrated, then pass the returned version to
+	// AcknowledgeInventorySnapshot once the write is confirmed
 }
 
 void UInventoryComponent::LoadInventoryState()
@@ -329,22 +753,31 @@ void UInventoryComponent::LoadInventoryState()
 	// Stub for future SpacetimeDB integration
 	// This would retrieve inventory data from SpacetimeDB and deserialize it
 	// TODO: Retrieve from SpacetimeDB when integrated
-	// FString SerializedData = GetFromSpacetimeDB();
-	// DeserializeInventory(SerializedData);
+	// TArray<uint8> SerializedData = GetFromSpacetimeDB();
+	// DeserializeInventoryBinary(SerializedData);
+	// for (const TArray<uint8>& SerializedDelta : GetDeltasFromSpacetimeDB()) { ApplyInventoryDelta(SerializedDelta); }
 }
 
 FString UInventoryComponent::SerializeInventory() const
 {
-	// Simple JSON-like serialization for persistence
+	// Simple JSON-like serialization for debugging
 	FString Result = TEXT("{\"slots\":[");
-	
+	Result.Reserve(InventorySlots.Num() * 32);
+
 	for (int32 i = 0; i < InventorySlots.Num(); ++i)
 	{
 		const FInventorySlot& Slot = InventorySlots[i];
-		if (Slot.Item)
+		if (Slot.Instance)
+		{
+			TArray<uint8> Payload;
+			SaveItemInstance(Slot.Instance, Payload);
+			Result += FString::Printf(TEXT("{\"itemID\":%d,\"quantity\":%d,\"instance\":\"%s\"}"),
+				Slot.ItemID, Slot.Quantity, *FBase64::Encode(Payload));
+		}
+		else if (!Slot.IsEmpty())
 		{
 			Result += FString::Printf(TEXT("{\"itemID\":%d,\"quantity\":%d}"),
-				Slot.Item->ItemID, Slot.Quantity);
+				Slot.ItemID, Slot.Quantity);
 		}
 		else
 		{
@@ -357,56 +790,1138 @@ FString UInventoryComponent::SerializeInventory() const
 		}
 	}
 
+	Result += TEXT("],\"resources\":[");
+
+	bool bFirstResource = true;
+	for (int32 Type = 0; Type < NumResourceTypes; ++Type)
+	{
+		if (ResourceCounts.Counts[Type] == 0)
+		{
+			continue;
+		}
+
+		if (!bFirstResource)
+		{
+			Result += TEXT(",");
+		}
+		Result += FString::Printf(TEXT("{\"type\":%d,\"quantity\":%d}"),
+			Type, ResourceCounts.Counts[Type]);
+		bFirstResource = false;
+	}
+
 	Result += TEXT("]}");
 	return Result;
 }
 
 bool UInventoryComponent::DeserializeInventory(const FString& JsonString)
 {
-	// Stub for deserialization
-	// In a full implementation, this would parse the JSON and recreate inventory state
-	// TODO: Implement proper JSON parsing when item database is available
-	return false;
+	TSharedPtr<FJsonObject> Root;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), Root) || !Root.IsValid())
+	{
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* JsonSlots = nullptr;
+	if (!Root->TryGetArrayField(TEXT("slots"), JsonSlots) || JsonSlots->Num() > MaxSlots)
+	{
+		return false;
+	}
+
+	TArray<FInventorySlot> NewSlots;
+	NewSlots.SetNum(MaxSlots);
+	for (int32 i = 0; i < JsonSlots->Num(); ++i)
+	{
+		const TSharedPtr<FJsonObject>* JsonSlot = nullptr;
+		int32 ItemID = 0;
+		int32 Quantity = 0;
+		if (!(*JsonSlots)[i]->TryGetObject(JsonSlot)
+			|| !(*JsonSlot)->TryGetNumberField(TEXT("itemID"), ItemID)
+			|| !(*JsonSlot)->TryGetNumberField(TEXT("quantity"), Quantity))
+		{
+			return false;
+		}
+
+		if (ItemID < 0)
+		{
+			continue;
+		}
+
+		FString EncodedInstance;
+		if ((*JsonSlot)->TryGetStringField(TEXT("instance"), EncodedInstance))
+		{
+			TArray<uint8> Payload;
+			UItem* Instance = FBase64::Decode(EncodedInstance, Payload) ? LoadItemInstance(this, Payload) : nullptr;
+			if (!Instance || Instance->ItemID != ItemID || Quantity != 1)
+			{
+				return false;
+			}
+			NewSlots[i] = FInventorySlot(ItemID, 1, Instance);
+			continue;
+		}
+
+		if (!IsKnownItemID(ItemID) || Quantity <= 0)
+		{
+			return false;
+		}
+		NewSlots[i] = FInventorySlot(ItemID, Quantity);
+	}
+
+	FResourceCounts NewResources;
+	const TArray<TSharedPtr<FJsonValue>>* JsonResources = nullptr;
+	if (Root->TryGetArrayField(TEXT("resources"), JsonResources))
+	{
+		for (const TSharedPtr<FJsonValue>& JsonValue : *JsonResources)
+		{
+			const TSharedPtr<FJsonObject>* JsonResource = nullptr;
+			int32 Type = 0;
+			int32 Quantity = 0;
+			if (!JsonValue->TryGetObject(JsonResource)
+				|| !(*JsonResource)->TryGetNumberField(TEXT("type"), Type)
+				|| !(*JsonResource)->TryGetNumberField(TEXT("quantity"), Quantity)
+				|| Type < 0 || Type >= NumResourceTypes || !IsHeldResourceType(static_cast<EResourceType>(Type)))
+			{
+				return false;
+			}
+			NewResources[static_cast<EResourceType>(Type)] = Quantity;
+		}
+	}
+
+	// A debug import doesn't match anything in storage, so the next delta must carry all of it
+	RestoreInventory(NewSlots, NewResources, SnapshotVersion);
+	MarkAllSlotsDirty();
+	MarkResourcesDirty();
+	return true;
 }
 
-void UInventoryComponent::UpdateWeight()
+void UInventoryComponent::SerializeInventoryBinary(TArray<uint8>& OutData) const
 {
-	CurrentWeight = 0.0f;
-	for (const FInventorySlot& Slot : InventorySlots)
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+
+	uint8 Version = InventoryBinaryVersion;
+	Writer << Version;
+
+	uint32 PackedSnapshotVersion = static_cast<uint32>(SnapshotVersion);
+	Writer.SerializeIntPacked(PackedSnapshotVersion);
+
+	uint32 NumSlots = InventorySlots.Num();
+	uint32 NumOccupied = InventorySlots.Num() - FreeSlotHeap.Num();
+	Writer.SerializeIntPacked(NumSlots);
+	Writer.SerializeIntPacked(NumOccupied);
+
+	// Empty slots are implied by the gap to the next occupied one
+	int32 PreviousSlot = -1;
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
 	{
-		if (Slot.Item)
+		const FInventorySlot& Slot = InventorySlots[i];
+		if (Slot.IsEmpty())
+		{
+			continue;
+		}
+
+		uint32 Gap = i - PreviousSlot - 1;
+		uint32 ItemID = static_cast<uint32>(Slot.ItemID);
+		uint32 PackedQuantity = PackSlotQuantity(Slot);
+		Writer.SerializeIntPacked(Gap);
+		Writer.SerializeIntPacked(ItemID);
+		Writer.SerializeIntPacked(PackedQuantity);
+		if (Slot.Instance)
 		{
-			CurrentWeight += Slot.Item->Weight * Slot.Quantity;
+			WriteItemInstance(Writer, Slot.Instance);
 		}
+		PreviousSlot = i;
 	}
+
+	WriteResourceCounts(Writer);
 }
 
-int32 UInventoryComponent::FindEmptySlot() const
+bool UInventoryComponent::DeserializeInventoryBinary(const TArray<uint8>& Data)
 {
-	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	FMemoryReader Reader(Data);
+
+	uint8 Version = 0;
+	Reader << Version;
+	if (Reader.IsError() || Version != InventoryBinaryVersion)
+	{
+		return false;
+	}
+
+	uint32 PackedSnapshotVersion = 0;
+	Reader.SerializeIntPacked(PackedSnapshotVersion);
+
+	uint32 NumSlots = 0;
+	uint32 NumOccupied = 0;
+	Reader.SerializeIntPacked(NumSlots);
+	Reader.SerializeIntPacked(NumOccupied);
+	if (Reader.IsError() || NumSlots > static_cast<uint32>(FMath::Max(MaxSlots, 0)) || NumOccupied > NumSlots)
+	{
+		return false;
+	}
+
+	TArray<FInventorySlot> NewSlots;
+	NewSlots.SetNum(MaxSlots);
+	int64 SlotIndex = -1;
+	for (uint32 i = 0; i < NumOccupied; ++i)
+	{
+		uint32 Gap = 0;
+		uint32 ItemID = 0;
+		uint32 PackedQuantity = 0;
+		Reader.SerializeIntPacked(Gap);
+		Reader.SerializeIntPacked(ItemID);
+		Reader.SerializeIntPacked(PackedQuantity);
+
+		const uint32 Quantity = PackedQuantity >> 1;
+		SlotIndex += static_cast<int64>(Gap) + 1;
+		if (Reader.IsError() || SlotIndex >= NumSlots || Quantity == 0)
+		{
+			return false;
+		}
+
+		if (PackedQuantity & 1)
+		{
+			UItem* Instance = ReadItemInstance(Reader, this);
+			if (!Instance || Instance->ItemID != static_cast<int32>(ItemID) || Quantity != 1)
+			{
+				return false;
+			}
+			NewSlots[static_cast<int32>(SlotIndex)] = FInventorySlot(Instance->ItemID, 1, Instance);
+			continue;
+		}
+
+		if (!IsKnownItemID(static_cast<int32>(ItemID)))
+		{
+			return false;
+		}
+		NewSlots[static_cast<int32>(SlotIndex)] = FInventorySlot(static_cast<int32>(ItemID), static_cast<int32>(Quantity));
+	}
+
+	FResourceCounts NewResources;
+	if (!ReadResourceCounts(Reader, NewResources))
+	{
+		return false;
+	}
+
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	if (PackedSnapshotVersion > MAX_int32)
+	{
+		return false;
+	}
+
+	RestoreInventory(NewSlots, NewResources, static_cast<int32>(PackedSnapshotVersion));
+	return true;
+}
+
+int32 UInventoryComponent::BuildInventoryDelta(TArray<uint8>& OutData)
+{
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+
+	uint32 BaseVersion = static_cast<uint32>(AcknowledgedVersion);
+	uint32 Version = static_cast<uint32>(++SnapshotVersion);
+	uint8 FormatVersion = InventoryDeltaVersion;
+	Writer << FormatVersion;
+	Writer.SerializeIntPacked(BaseVersion);
+	Writer.SerializeIntPacked(Version);
+
+	uint32 NumSlots = InventorySlots.Num();
+	Writer.SerializeIntPacked(NumSlots);
+
+	// Sorted so slot positions can be gap-encoded like the full snapshot
+	TArray<int32> ChangedSlots = DirtySlots;
+	ChangedSlots.Sort();
+
+	uint32 NumChanged = ChangedSlots.Num();
+	Writer.SerializeIntPacked(NumChanged);
+
+	int32 PreviousSlot = -1;
+	for (int32 SlotIndex : ChangedSlots)
+	{
+		const FInventorySlot& Slot = InventorySlots[SlotIndex];
+		uint32 Gap = SlotIndex - PreviousSlot - 1;
+		uint32 PackedQuantity = PackSlotQuantity(Slot);
+		Writer.SerializeIntPacked(Gap);
+		Writer.SerializeIntPacked(PackedQuantity);
+
+		// Zero marks a slot that was emptied; no ItemID follows
+		if (PackedQuantity > 0)
+		{
+			uint32 ItemID = static_cast<uint32>(Slot.ItemID);
+			Writer.SerializeIntPacked(ItemID);
+		}
+		if (Slot.Instance)
+		{
+			WriteItemInstance(Writer, Slot.Instance);
+		}
+		PreviousSlot = SlotIndex;
+	}
+
+	uint8 bIncludesResources = ResourcesDirtyVersion != 0 ? 1 : 0;
+	Writer << bIncludesResources;
+	if (bIncludesResources)
+	{
+		WriteResourceCounts(Writer);
+	}
+
+	return SnapshotVersion;
+}
+
+void UInventoryComponent::AcknowledgeInventorySnapshot(int32 Version)
+{
+	if (Version <= AcknowledgedVersion || Version > SnapshotVersion)
+	{
+		return;
+	}
+
+	AcknowledgedVersion = Version;
+
+	// Slots changed after the acknowledged delta was built stay dirty
+	for (int32 i = DirtySlots.Num() - 1; i >= 0; --i)
 	{
-		if (!InventorySlots[i].Item)
+		const int32 SlotIndex = DirtySlots[i];
+		if (SlotDirtyVersions[SlotIndex] <= Version)
 		{
-			return i;
+			DirtySlotFlags[SlotIndex] = false;
+			DirtySlots.RemoveAtSwap(i, 1, false);
 		}
 	}
-	return -1;
+
+	if (ResourcesDirtyVersion <= Version)
+	{
+		ResourcesDirtyVersion = 0;
+	}
 }
 
-int32 UInventoryComponent::FindStackableSlot(UItem* Item) const
+bool UInventoryComponent::ApplyInventoryDelta(const TArray<uint8>& Data)
 {
-	if (!Item || !Item->bIsStackable)
+	FMemoryReader Reader(Data);
+
+	uint8 FormatVersion = 0;
+	uint32 BaseVersion = 0;
+	uint32 Version = 0;
+	uint32 NumSlots = 0;
+	uint32 NumChanged = 0;
+	Reader << FormatVersion;
+	Reader.SerializeIntPacked(BaseVersion);
+	Reader.SerializeIntPacked(Version);
+	Reader.SerializeIntPacked(NumSlots);
+	Reader.SerializeIntPacked(NumChanged);
+	if (Reader.IsError() || FormatVersion != InventoryDeltaVersion || Version > MAX_int32
+		|| NumSlots != static_cast<uint32>(InventorySlots.Num()) || NumChanged > NumSlots)
+	{
+		return false;
+	}
+
+	// Already contained in what was loaded
+	if (static_cast<int32>(Version) <= SnapshotVersion)
 	{
-		return -1;
+		return true;
 	}
 
-	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	// Storage is missing the changes between our version and this delta's base
+	if (static_cast<int32>(BaseVersion) > SnapshotVersion)
 	{
-		const FInventorySlot& Slot = InventorySlots[i];
-		if (Slot.Item == Item && Slot.Quantity < Item->MaxStackSize)
+		return false;
+	}
+
+	// Decode everything before touching the inventory so a bad delta leaves it unchanged
+	TArray<int32> ChangedSlots;
+	TArray<FInventorySlot> ChangedContents;
+	ChangedSlots.Reserve(NumChanged);
+	ChangedContents.Reserve(NumChanged);
+
+	int64 SlotIndex = -1;
+	for (uint32 i = 0; i < NumChanged; ++i)
+	{
+		uint32 Gap = 0;
+		uint32 PackedQuantity = 0;
+		Reader.SerializeIntPacked(Gap);
+		Reader.SerializeIntPacked(PackedQuantity);
+
+		const uint32 Quantity = PackedQuantity >> 1;
+		SlotIndex += static_cast<int64>(Gap) + 1;
+		if (Reader.IsError() || SlotIndex >= NumSlots)
+		{
+			return false;
+		}
+
+		uint32 ItemID = static_cast<uint32>(INDEX_NONE);
+		if (PackedQuantity > 0)
+		{
+			Reader.SerializeIntPacked(ItemID);
+			if (Reader.IsError() || Quantity == 0)
+			{
+				return false;
+			}
+		}
+
+		UItem* Instance = nullptr;
+		if (PackedQuantity & 1)
+		{
+			Instance = ReadItemInstance(Reader, this);
+			if (!Instance || Instance->ItemID != static_cast<int32>(ItemID) || Quantity != 1)
+			{
+				return false;
+			}
+		}
+		else if (Quantity > 0 && !IsKnownItemID(static_cast<int32>(ItemID)))
+		{
+			return false;
+		}
+
+		ChangedSlots.Add(static_cast<int32>(SlotIndex));
+		ChangedContents.Emplace(static_cast<int32>(ItemID), static_cast<int32>(Quantity), Instance);
+	}
+
+	uint8 bIncludesResources = 0;
+	Reader << bIncludesResources;
+
+	FResourceCounts NewResources;
+	if (bIncludesResources && !ReadResourceCounts(Reader, NewResources))
+	{
+		return false;
+	}
+
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < ChangedSlots.Num(); ++i)
+	{
+		SetSlotContents(ChangedSlots[i], ChangedContents[i]);
+	}
+	if (bIncludesResources)
+	{
+		ResourceCounts = NewResources;
+	}
+
+	// What was just applied is by definition what storage holds
+	ResetDirtyTracking(static_cast<int32>(Version));
+
+	checkSlow(IsAccountingConsistent());
+	BroadcastSlotsChanged(ChangedSlots);
+	return true;
+}
+
+void UInventoryComponent::RestoreInventory(TArray<FInventorySlot>& NewSlots, const FResourceCounts& NewResources, int32 Version)
+{
+	InventorySlots = MoveTemp(NewSlots);
+	ResourceCounts = NewResources;
+	RebuildSlotIndex();
+	ResetDirtyTracking(Version);
+	BroadcastAllSlotsChanged();
+}
+
+void UInventoryComponent::WriteResourceCounts(FArchive& Writer) const
+{
+	uint32 NumResources = ResourceCounts.NumNonZero();
+	Writer.SerializeIntPacked(NumResources);
+	for (int32 i = 0; i < NumResourceTypes; ++i)
+	{
+		if (ResourceCounts.Counts[i] != 0)
+		{
+			uint8 Type = static_cast<uint8>(i);
+			uint32 Quantity = static_cast<uint32>(ResourceCounts.Counts[i]);
+			Writer << Type;
+			Writer.SerializeIntPacked(Quantity);
+		}
+	}
+}
+
+bool UInventoryComponent::ReadResourceCounts(FArchive& Reader, FResourceCounts& OutResources)
+{
+	uint32 NumResources = 0;
+	Reader.SerializeIntPacked(NumResources);
+	for (uint32 i = 0; i < NumResources && !Reader.IsError(); ++i)
+	{
+		uint8 Type = 0;
+		uint32 Quantity = 0;
+		Reader << Type;
+		Reader.SerializeIntPacked(Quantity);
+		if (!IsHeldResourceType(static_cast<EResourceType>(Type)) || Quantity > MAX_int32)
 		{
-			return i;
+			return false;
 		}
+		OutResources[static_cast<EResourceType>(Type)] = static_cast<int32>(Quantity);
+	}
+	return !Reader.IsError();
+}
+
+void UInventoryComponent::MarkSlotDirty(int32 SlotIndex)
+{
+	SlotDirtyVersions[SlotIndex] = SnapshotVersion + 1;
+	if (!DirtySlotFlags[SlotIndex])
+	{
+		DirtySlotFlags[SlotIndex] = true;
+		DirtySlots.Add(SlotIndex);
+	}
+}
+
+void UInventoryComponent::MarkAllSlotsDirty()
+{
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	{
+		MarkSlotDirty(i);
 	}
-	return -1;
+}
+
+void UInventoryComponent::MarkResourcesDirty()
+{
+	ResourcesDirtyVersion = SnapshotVersion + 1;
+}
+
+void UInventoryComponent::ResetDirtyTracking(int32 Version)
+{
+	SnapshotVersion = Version;
+	AcknowledgedVersion = Version;
+	DirtySlots.Reset();
+	DirtySlotFlags.Init(false, InventorySlots.Num());
+	SlotDirtyVersions.Init(0, InventorySlots.Num());
+	ResourcesDirtyVersion = 0;
+}
+
+void UInventoryComponent::UpdateWeight()
+{
+	WeightAccumulator = 0.0;
+	for (const FInventorySlot& Slot : InventorySlots)
+	{
+		if (!Slot.IsEmpty())
+		{
+			WeightAccumulator += static_cast<double>(GetUnitWeight(Slot.ItemID, Slot.Instance)) * Slot.Quantity;
+		}
+	}
+	CurrentWeight = static_cast<float>(WeightAccumulator);
+}
+
+int32 UInventoryComponent::FindEmptySlot() const
+{
+	return FreeSlotHeap.Num() > 0 ? FreeSlotHeap.HeapTop() : -1;
+}
+
+int32 UInventoryComponent::FindStackableSlot(int32 ItemID) const
+{
+	const FInventoryItemSlots* Entry = ItemSlotIndex.Find(ItemID);
+	return Entry && Entry->PartialSlots.Num() > 0 ? Entry->PartialSlots[0] : -1;
+}
+
+FInventoryItemSlots& UInventoryComponent::FindOrAddItemEntry(int32 ItemID)
+{
+	if (FInventoryItemSlots* Entry = ItemSlotIndex.Find(ItemID))
+	{
+		return *Entry;
+	}
+
+	FInventoryItemSlots& Entry = ItemSlotIndex.Add(ItemID);
+	UItemRegistry* Registry = UItemRegistry::Get();
+	if (const FItemHotData* HotData = Registry ? Registry->FindHotData(ItemID) : nullptr)
+	{
+		Entry.Weight = HotData->Weight;
+		Entry.StackLimit = HotData->StackLimit;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: item %d has no definition, treating it as weightless and unstackable"),
+			*GetName(), ItemID);
+	}
+	return Entry;
+}
+
+void UInventoryComponent::SetSlotContents(int32 SlotIndex, const FInventorySlot& NewContents)
+{
+	FInventorySlot NewSlot = NewContents;
+	if (NewSlot.Quantity <= 0 || (NewSlot.ItemID == INDEX_NONE && !NewSlot.Instance))
+	{
+		NewSlot = FInventorySlot();
+	}
+	else if (NewSlot.Instance)
+	{
+		checkSlow(NewSlot.Quantity == 1);
+		NewSlot.ItemID = NewSlot.Instance->ItemID;
+	}
+
+	FInventorySlot& Slot = InventorySlots[SlotIndex];
+	const bool bWasEmpty = Slot.IsEmpty();
+	const bool bIsEmpty = NewSlot.IsEmpty();
+	const bool bSameItem = bWasEmpty ? bIsEmpty : !bIsEmpty && Slot.HoldsSameItem(NewSlot);
+
+	if (!bWasEmpty)
+	{
+		if (Slot.Instance)
+		{
+			WeightAccumulator -= Slot.Instance->Weight;
+		}
+		else
+		{
+			FInventoryItemSlots& OldEntry = ItemSlotIndex.FindChecked(Slot.ItemID);
+			WeightAccumulator -= static_cast<double>(OldEntry.Weight) * Slot.Quantity;
+			OldEntry.TotalQuantity -= Slot.Quantity;
+		}
+	}
+
+	if (!bSameItem)
+	{
+		if (bWasEmpty)
+		{
+			// Slots are normally filled from the top of the heap; anything else is a rare targeted write
+			if (FreeSlotHeap.HeapTop() == SlotIndex)
+			{
+				FreeSlotHeap.HeapPopDiscard(false);
+			}
+			else
+			{
+				FreeSlotHeap.HeapRemoveAt(FreeSlotHeap.Find(SlotIndex), false);
+			}
+		}
+		else if (Slot.Instance)
+		{
+			InstanceSlotIndex.Remove(Slot.Instance);
+		}
+		else
+		{
+			FInventoryItemSlots& OldEntry = ItemSlotIndex.FindChecked(Slot.ItemID);
+			RemoveSorted(OldEntry.Slots, SlotIndex);
+			RemoveSorted(OldEntry.PartialSlots, SlotIndex);
+			if (OldEntry.Slots.Num() == 0)
+			{
+				ItemSlotIndex.Remove(Slot.ItemID);
+			}
+		}
+
+		if (bIsEmpty)
+		{
+			FreeSlotHeap.HeapPush(SlotIndex);
+		}
+		else if (NewSlot.Instance)
+		{
+			InstanceSlotIndex.Add(NewSlot.Instance, SlotIndex);
+		}
+		else
+		{
+			FInventoryItemSlots& NewEntry = FindOrAddItemEntry(NewSlot.ItemID);
+			InsertSorted(NewEntry.Slots, SlotIndex);
+			if (IsPartialStack(NewEntry, NewSlot.Quantity))
+			{
+				InsertSorted(NewEntry.PartialSlots, SlotIndex);
+			}
+		}
+	}
+	else if (!bIsEmpty && !NewSlot.Instance)
+	{
+		FInventoryItemSlots& Entry = ItemSlotIndex.FindChecked(NewSlot.ItemID);
+		if (IsPartialStack(Entry, Slot.Quantity) != IsPartialStack(Entry, NewSlot.Quantity))
+		{
+			if (IsPartialStack(Entry, NewSlot.Quantity))
+			{
+				InsertSorted(Entry.PartialSlots, SlotIndex);
+			}
+			else
+			{
+				RemoveSorted(Entry.PartialSlots, SlotIndex);
+			}
+		}
+	}
+
+	if (!bIsEmpty)
+	{
+		if (NewSlot.Instance)
+		{
+			WeightAccumulator += NewSlot.Instance->Weight;
+		}
+		else
+		{
+			FInventoryItemSlots& NewEntry = ItemSlotIndex.FindChecked(NewSlot.ItemID);
+			WeightAccumulator += static_cast<double>(NewEntry.Weight) * NewSlot.Quantity;
+			NewEntry.TotalQuantity += NewSlot.Quantity;
+		}
+	}
+
+	// Snap to zero once the bag is empty so float residue can't block MaxWeight checks
+	if (FreeSlotHeap.Num() == InventorySlots.Num())
+	{
+		WeightAccumulator = 0.0;
+	}
+	CurrentWeight = static_cast<float>(WeightAccumulator);
+
+	Slot = NewSlot;
+	MarkSlotDirty(SlotIndex);
+	UpdateReplicatedSlot(SlotIndex);
+}
+
+void UInventoryComponent::RebuildSlotIndex()
+{
+	// Keep dirty state for surviving slots; slots added by a resize start clean
+	SlotDirtyVersions.SetNumZeroed(InventorySlots.Num());
+	DirtySlotFlags.SetNum(InventorySlots.Num(), false);
+	DirtySlots.RemoveAll([this](int32 SlotIndex) { return SlotIndex >= InventorySlots.Num(); });
+
+	RebuildItemIndices();
+	UpdateWeight();
+	RebuildReplicatedSlots();
+}
+
+void UInventoryComponent::RebuildItemIndices()
+{
+	ItemSlotIndex.Reset();
+	InstanceSlotIndex.Reset();
+	FreeSlotHeap.Reset();
+
+	// Ascending iteration keeps every per-item list sorted and the free list a valid heap
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	{
+		FInventorySlot& Slot = InventorySlots[i];
+		if (Slot.IsEmpty())
+		{
+			// Normalize so an empty slot never keeps a stale ID or instance around
+			Slot = FInventorySlot();
+			FreeSlotHeap.Add(i);
+		}
+		else if (Slot.Instance)
+		{
+			Slot.ItemID = Slot.Instance->ItemID;
+			InstanceSlotIndex.Add(Slot.Instance, i);
+		}
+		else
+		{
+			FInventoryItemSlots& Entry = FindOrAddItemEntry(Slot.ItemID);
+			Entry.Slots.Add(i);
+			Entry.TotalQuantity += Slot.Quantity;
+			if (IsPartialStack(Entry, Slot.Quantity))
+			{
+				Entry.PartialSlots.Add(i);
+			}
+		}
+	}
+}
+
+bool UInventoryComponent::WritesReplicatedSlots() const
+{
+	const AActor* Owner = GetOwner();
+	return !Owner || Owner->HasAuthority();
+}
+
+void UInventoryComponent::UpdateReplicatedSlot(int32 SlotIndex)
+{
+	if (!WritesReplicatedSlots())
+	{
+		return;
+	}
+
+	const FInventorySlot& Slot = InventorySlots[SlotIndex];
+	int32& EntryIndex = ReplicatedEntryIndices[SlotIndex];
+
+	if (!Slot.IsEmpty())
+	{
+		if (EntryIndex == INDEX_NONE)
+		{
+			EntryIndex = ReplicatedSlots.Entries.AddDefaulted();
+			ReplicatedSlots.Entries[EntryIndex].SlotIndex = SlotIndex;
+		}
+
+		FReplicatedInventorySlot& Entry = ReplicatedSlots.Entries[EntryIndex];
+		Entry.ItemID = Slot.ItemID;
+		Entry.Quantity = Slot.Quantity;
+		SetReplicatedInstance(Entry, Slot.Instance);
+		ReplicatedSlots.MarkItemDirty(Entry);
+	}
+	else if (EntryIndex != INDEX_NONE)
+	{
+		// Swap-remove, repointing the slot whose entry moves into the hole
+		const int32 LastEntryIndex = ReplicatedSlots.Entries.Num() - 1;
+		if (EntryIndex != LastEntryIndex)
+		{
+			ReplicatedEntryIndices[ReplicatedSlots.Entries[LastEntryIndex].SlotIndex] = EntryIndex;
+		}
+		ReplicatedSlots.Entries.RemoveAtSwap(EntryIndex, 1, false);
+		EntryIndex = INDEX_NONE;
+		ReplicatedSlots.MarkArrayDirty();
+	}
+}
+
+void UInventoryComponent::RebuildReplicatedSlots()
+{
+	if (!WritesReplicatedSlots())
+	{
+		return;
+	}
+
+	ReplicatedSlots.Entries.Reset();
+	ReplicatedEntryIndices.Init(INDEX_NONE, InventorySlots.Num());
+
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	{
+		const FInventorySlot& Slot = InventorySlots[i];
+		if (!Slot.IsEmpty())
+		{
+			ReplicatedEntryIndices[i] = ReplicatedSlots.Entries.AddDefaulted();
+			FReplicatedInventorySlot& Entry = ReplicatedSlots.Entries.Last();
+			Entry.SlotIndex = i;
+			Entry.ItemID = Slot.ItemID;
+			Entry.Quantity = Slot.Quantity;
+			SetReplicatedInstance(Entry, Slot.Instance);
+			ReplicatedSlots.MarkItemDirty(Entry);
+		}
+	}
+
+	ReplicatedSlots.MarkArrayDirty();
+}
+
+void UInventoryComponent::RemoveFromSlots(const FInventoryItemAmount& Amount, TArray<int32>& OutChangedSlots)
+{
+	if (Amount.Instance)
+	{
+		const int32 SlotIndex = InstanceSlotIndex.FindChecked(Amount.Instance);
+		SetSlotContents(SlotIndex, FInventorySlot());
+		OutChangedSlots.Add(SlotIndex);
+		return;
+	}
+
+	// Copy the slot list, since emptying slots edits the index while we walk it
+	const TArray<int32> ItemSlots = ItemSlotIndex.FindChecked(Amount.ItemID).Slots;
+	int32 RemainingQuantity = Amount.Quantity;
+
+	for (int32 i = 0; i < ItemSlots.Num() && RemainingQuantity > 0; ++i)
+	{
+		const int32 SlotIndex = ItemSlots[i];
+		const int32 SlotQuantity = InventorySlots[SlotIndex].Quantity;
+		int32 AmountToRemove = FMath::Min(RemainingQuantity, SlotQuantity);
+
+		SetSlotContents(SlotIndex, FInventorySlot(Amount.ItemID, SlotQuantity - AmountToRemove));
+		OutChangedSlots.Add(SlotIndex);
+		RemainingQuantity -= AmountToRemove;
+	}
+
+	check(RemainingQuantity == 0);
+}
+
+void UInventoryComponent::AddToSlots(const FInventoryItemAmount& Amount, TArray<int32>& OutChangedSlots)
+{
+	if (Amount.Instance)
+	{
+		const int32 EmptySlot = FindEmptySlot();
+		check(EmptySlot != -1);
+
+		SetSlotContents(EmptySlot, FInventorySlot(Amount.ItemID, 1, Amount.Instance));
+		OutChangedSlots.Add(EmptySlot);
+		return;
+	}
+
+	const int32 StackLimit = GetStackLimit(Amount.ItemID, nullptr);
+	int32 RemainingQuantity = Amount.Quantity;
+
+	// A filled stack drops out of the partial index, so each lookup moves on to the next one
+	int32 StackableSlot = FindStackableSlot(Amount.ItemID);
+	while (StackableSlot != -1 && RemainingQuantity > 0)
+	{
+		const int32 SlotQuantity = InventorySlots[StackableSlot].Quantity;
+		int32 AmountToAdd = FMath::Min(RemainingQuantity, StackLimit - SlotQuantity);
+
+		SetSlotContents(StackableSlot, FInventorySlot(Amount.ItemID, SlotQuantity + AmountToAdd));
+		OutChangedSlots.Add(StackableSlot);
+		RemainingQuantity -= AmountToAdd;
+
+		StackableSlot = FindStackableSlot(Amount.ItemID);
+	}
+
+	// Add remaining items to empty slots
+	while (RemainingQuantity > 0)
+	{
+		int32 EmptySlot = FindEmptySlot();
+		check(EmptySlot != -1);
+
+		int32 AmountToAdd = FMath::Min(RemainingQuantity, StackLimit);
+		SetSlotContents(EmptySlot, FInventorySlot(Amount.ItemID, AmountToAdd));
+		OutChangedSlots.Add(EmptySlot);
+		RemainingQuantity -= AmountToAdd;
+	}
+}
+
+bool UInventoryComponent::PlanTransaction(const FInventoryTransaction& Transaction,
+	TArray<FInventoryItemAmount>& OutRemoves, TArray<FInventoryItemAmount>& OutAdds) const
+{
+	if (!AggregateByItem(Transaction.ItemsToRemove, OutRemoves) || !AggregateByItem(Transaction.ItemsToAdd, OutAdds))
+	{
+		return false;
+	}
+
+	if (OutRemoves.Num() == 0 && OutAdds.Num() == 0)
+	{
+		return false;
+	}
+
+	double WeightDelta = 0.0;
+	int32 AvailableSlots = FreeSlotHeap.Num();
+
+	// Every remove must be covered; count the slots it would empty
+	for (const FInventoryItemAmount& Remove : OutRemoves)
+	{
+		if (Remove.Instance)
+		{
+			// A unique instance fills exactly one slot
+			if (Remove.Quantity != 1 || !InstanceSlotIndex.Contains(Remove.Instance))
+			{
+				return false;
+			}
+
+			WeightDelta -= Remove.Instance->Weight;
+			++AvailableSlots;
+			continue;
+		}
+
+		const FInventoryItemSlots* Entry = ItemSlotIndex.Find(Remove.ItemID);
+		if (!Entry || Entry->TotalQuantity < Remove.Quantity)
+		{
+			return false;
+		}
+
+		WeightDelta -= static_cast<double>(Entry->Weight) * Remove.Quantity;
+
+		// Mirrors RemoveFromSlots: drains slots in ascending order until the quantity is met
+		int32 RemainingQuantity = Remove.Quantity;
+		for (int32 SlotIndex : Entry->Slots)
+		{
+			const int32 SlotQuantity = InventorySlots[SlotIndex].Quantity;
+			if (RemainingQuantity < SlotQuantity)
+			{
+				break;
+			}
+			RemainingQuantity -= SlotQuantity;
+			++AvailableSlots;
+		}
+	}
+
+	// Every add must fit into existing stacks plus the free slots left after the removes
+	for (const FInventoryItemAmount& Add : OutAdds)
+	{
+		if (Add.Instance)
+		{
+			// Unique instances never stack; one can be re-added only in the transaction that removes it
+			const bool bRemovedHere = OutRemoves.ContainsByPredicate([&Add](const FInventoryItemAmount& Candidate)
+			{
+				return Candidate.Instance == Add.Instance;
+			});
+			if (Add.Quantity != 1 || (InstanceSlotIndex.Contains(Add.Instance) && !bRemovedHere) || --AvailableSlots < 0)
+			{
+				return false;
+			}
+
+			WeightDelta += Add.Instance->Weight;
+			continue;
+		}
+
+		const float UnitWeight = GetUnitWeight(Add.ItemID, nullptr);
+		if (UnitWeight < 0.0f)
+		{
+			return false;
+		}
+		WeightDelta += static_cast<double>(UnitWeight) * Add.Quantity;
+
+		const int32 StackLimit = GetStackLimit(Add.ItemID, nullptr);
+		int32 UnplacedQuantity = Add.Quantity;
+
+		const FInventoryItemSlots* Entry = ItemSlotIndex.Find(Add.ItemID);
+		if (Entry && StackLimit > 1)
+		{
+			const FInventoryItemAmount* Remove = OutRemoves.FindByPredicate([&Add](const FInventoryItemAmount& Candidate)
+			{
+				return !Candidate.Instance && Candidate.ItemID == Add.ItemID;
+			});
+			int32 RemovedQuantity = Remove ? Remove->Quantity : 0;
+
+			// Room in this item's stacks as they will stand once its removes have drained them
+			for (int32 SlotIndex : Entry->Slots)
+			{
+				const int32 SlotQuantity = InventorySlots[SlotIndex].Quantity;
+				const int32 Drained = FMath::Min(RemovedQuantity, SlotQuantity);
+				RemovedQuantity -= Drained;
+				if (SlotQuantity > Drained)
+				{
+					UnplacedQuantity -= StackLimit - (SlotQuantity - Drained);
+				}
+			}
+		}
+
+		if (UnplacedQuantity > 0)
+		{
+			AvailableSlots -= FMath::DivideAndRoundUp(UnplacedQuantity, StackLimit);
+			if (AvailableSlots < 0)
+			{
+				return false;
+			}
+		}
+	}
+
+	// Only a transaction that adds weight can be refused for it, so an overweight bag can still shed items
+	return WeightDelta <= 0.0 || WeightAccumulator + WeightDelta <= MaxWeight;
+}
+
+void UInventoryComponent::BroadcastSlotsChanged(TArray<int32>& ChangedSlots)
+{
+	// A slot can be drained and refilled within one transaction; report it once
+	ChangedSlots.Sort();
+	ChangedSlots.SetNum(Algo::Unique(ChangedSlots), false);
+
+	OnInventorySlotsChanged.Broadcast(this, ChangedSlots);
+	OnInventoryChanged.Broadcast(this);
+}
+
+void UInventoryComponent::BroadcastAllSlotsChanged()
+{
+	TArray<int32> ChangedSlots;
+	ChangedSlots.Reserve(InventorySlots.Num());
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	{
+		ChangedSlots.Add(i);
+	}
+	BroadcastSlotsChanged(ChangedSlots);
+}
+
+FInventoryItemAmount UInventoryComponent::MakeItemAmount(UItem* Item, int32 Quantity) const
+{
+	UItemRegistry* Registry = UItemRegistry::Get();
+	if (!Item || !Registry)
+	{
+		return FInventoryItemAmount(Item ? Item->ItemID : INDEX_NONE, Quantity, Item);
+	}
+
+	if (Registry->IsDefinition(Item))
+	{
+		return FInventoryItemAmount(Item->ItemID, Quantity);
+	}
+
+	// Definitions come from data or startup registration on every machine, never from a query here
+	if (Item->bIsStackable)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: %s is not the registered definition for item %d, so it is held as a unique instance and will not stack"),
+			*GetName(), *Item->GetName(), Item->ItemID);
+	}
+	return FInventoryItemAmount(Item->ItemID, Quantity, Item);
+}
+
+float UInventoryComponent::GetUnitWeight(int32 ItemID, const UItem* Instance) const
+{
+	if (Instance)
+	{
+		return Instance->Weight;
+	}
+
+	// Items already in the bag use the values cached when they entered it
+	if (const FInventoryItemSlots* Entry = ItemSlotIndex.Find(ItemID))
+	{
+		return Entry->Weight;
+	}
+
+	UItemRegistry* Registry = UItemRegistry::Get();
+	const FItemHotData* HotData = Registry ? Registry->FindHotData(ItemID) : nullptr;
+	return HotData ? HotData->Weight : -1.0f;
+}
+
+int32 UInventoryComponent::GetStackLimit(int32 ItemID, const UItem* Instance) const
+{
+	if (Instance)
+	{
+		return 1;
+	}
+
+	if (const FInventoryItemSlots* Entry = ItemSlotIndex.Find(ItemID))
+	{
+		return Entry->StackLimit;
+	}
+
+	UItemRegistry* Registry = UItemRegistry::Get();
+	const FItemHotData* HotData = Registry ? Registry->FindHotData(ItemID) : nullptr;
+	return HotData ? HotData->StackLimit : 1;
+}
+
+bool UInventoryComponent::IsKnownItemID(int32 ItemID)
+{
+	UItemRegistry* Registry = UItemRegistry::Get();
+	return Registry && Registry->FindHotData(ItemID) != nullptr;
+}
+
+bool UInventoryComponent::IsPartialStack(const FInventoryItemSlots& Entry, int32 Quantity)
+{
+	return Quantity < Entry.StackLimit;
+}
+
+bool UInventoryComponent::IsAccountingConsistent() const
+{
+	bool bConsistent = true;
+
+	double RecomputedWeight = 0.0;
+	int32 RecomputedEmptySlots = 0;
+	int32 RecomputedInstances = 0;
+	TMap<int32, int32> RecomputedTotals;
+	for (int32 i = 0; i < InventorySlots.Num(); ++i)
+	{
+		const FInventorySlot& Slot = InventorySlots[i];
+		if (Slot.IsEmpty())
+		{
+			++RecomputedEmptySlots;
+		}
+		else if (Slot.Instance)
+		{
+			RecomputedWeight += Slot.Instance->Weight;
+			++RecomputedInstances;
+
+			const int32* IndexedSlot = InstanceSlotIndex.Find(Slot.Instance);
+			if (!IndexedSlot || *IndexedSlot != i)
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s: unique item in slot %d is indexed at slot %d"),
+					*GetName(), i, IndexedSlot ? *IndexedSlot : -1);
+				bConsistent = false;
+			}
+		}
+		else
+		{
+			const FInventoryItemSlots* Entry = ItemSlotIndex.Find(Slot.ItemID);
+			RecomputedWeight += static_cast<double>(Entry ? Entry->Weight : 0.0f) * Slot.Quantity;
+			RecomputedTotals.FindOrAdd(Slot.ItemID) += Slot.Quantity;
+		}
+	}
+
+	if (!FMath::IsNearlyEqual(WeightAccumulator, RecomputedWeight, 0.001))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: running weight %.3f, recomputed %.3f"),
+			*GetName(), WeightAccumulator, RecomputedWeight);
+		bConsistent = false;
+	}
+
+	if (FreeSlotHeap.Num() != RecomputedEmptySlots)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: running empty slot count %d, recomputed %d"),
+			*GetName(), FreeSlotHeap.Num(), RecomputedEmptySlots);
+		bConsistent = false;
+	}
+
+	if (InstanceSlotIndex.Num() != RecomputedInstances)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: %d unique items indexed, %d in slots"),
+			*GetName(), InstanceSlotIndex.Num(), RecomputedInstances);
+		bConsistent = false;
+	}
+
+	if (ItemSlotIndex.Num() != RecomputedTotals.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s: %d items indexed, %d in slots"),
+			*GetName(), ItemSlotIndex.Num(), RecomputedTotals.Num());
+		bConsistent = false;
+	}
+
+	for (const TPair<int32, int32>& Total : RecomputedTotals)
+	{
+		const FInventoryItemSlots* Entry = ItemSlotIndex.Find(Total.Key);
+		const int32 RunningTotal = Entry ? Entry->TotalQuantity : 0;
+		if (RunningTotal != Total.Value)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s: running total for item %d is %d, recomputed %d"),
+				*GetName(), Total.Key, RunningTotal, Total.Value);
+			bConsistent = false;
+		}
+	}
+
+	return bConsistent;
 }
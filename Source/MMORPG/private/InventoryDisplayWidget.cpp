@@ -1,13 +1,89 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "InventoryDisplayWidget.h"
+#include "InventoryComponent.h"
+#include "EquipmentItem.h"
 
 void UInventoryDisplayWidget::NativeConstruct()
 {
 	Super::NativeConstruct();
 	
-	// Initialize with placeholder inventory
-	InitializePlaceholderInventory();
+	// Initialize with placeholder inventory unless a real one was bound first
+	if (!BoundInventory)
+	{
+		InitializePlaceholderInventory();
+	}
+}
+
+void UInventoryDisplayWidget::NativeDestruct()
+{
+	BindToInventory(nullptr);
+
+	Super::NativeDestruct();
+}
+
+void UInventoryDisplayWidget::BindToInventory(UInventoryComponent* Inventory)
+{
+	if (BoundInventory)
+	{
+		BoundInventory->OnInventorySlotsChanged.RemoveDynamic(this, &UInventoryDisplayWidget::OnInventorySlotsChanged);
+	}
+
+	BoundInventory = Inventory;
+	if (!BoundInventory)
+	{
+		return;
+	}
+
+	// One full pass on bind; after that only reported slots are refreshed
+	MaxInventorySlots = BoundInventory->InventorySlots.Num();
+	InventoryItems.SetNum(MaxInventorySlots);
+	for (int32 i = 0; i < MaxInventorySlots; ++i)
+	{
+		RefreshSlot(i);
+	}
+
+	BoundInventory->OnInventorySlotsChanged.AddDynamic(this, &UInventoryDisplayWidget::OnInventorySlotsChanged);
+	OnInventoryRefreshed();
+}
+
+void UInventoryDisplayWidget::OnInventorySlotsChanged(UInventoryComponent* Inventory, const TArray<int32>& ChangedSlots)
+{
+	// The bag can be resized underneath us (e.g. first replication before BeginPlay)
+	if (Inventory->InventorySlots.Num() != InventoryItems.Num())
+	{
+		BindToInventory(Inventory);
+		return;
+	}
+
+	for (int32 SlotIndex : ChangedSlots)
+	{
+		if (InventoryItems.IsValidIndex(SlotIndex))
+		{
+			RefreshSlot(SlotIndex);
+			OnSlotRefreshed(SlotIndex);
+		}
+	}
+}
+
+void UInventoryDisplayWidget::RefreshSlot(int32 SlotIndex)
+{
+	if (!BoundInventory || !InventoryItems.IsValidIndex(SlotIndex))
+	{
+		return;
+	}
+
+	const FInventorySlot Slot = BoundInventory->GetItemAtSlot(SlotIndex);
+	FInventoryItem DisplayItem;
+	if (const UItem* Item = BoundInventory->GetSlotItem(SlotIndex))
+	{
+		DisplayItem.ItemName = Item->ItemName;
+		DisplayItem.Quantity = Slot.Quantity;
+		DisplayItem.ItemType = Item->IsA<UEquipmentItem>() ? TEXT("Equipment") : TEXT("Misc");
+		DisplayItem.Description = Item->Description;
+		DisplayItem.ItemValue = Item->Value;
+	}
+	InventoryItems[SlotIndex] = DisplayItem;
 }
 
 void UInventoryDisplayWidget::InitializePlaceholderInventory()
@@ -61,6 +137,13 @@ void UInventoryDisplayWidget::RefreshInventory()
 
 bool UInventoryDisplayWidget::AddItem(const FInventoryItem& Item)
 {
+	// Display items carry no item ID, so they cannot go into a real inventory
+	if (BoundInventory)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: AddItem is for placeholder data; add items to the bound inventory instead"), *GetName());
+		return false;
+	}
+
 	// Find first empty slot
 	for (int32 i = 0; i < InventoryItems.Num(); ++i)
 	{
@@ -75,6 +158,13 @@ bool UInventoryDisplayWidget::AddItem(const FInventoryItem& Item)
 
 bool UInventoryDisplayWidget::RemoveItem(int32 SlotIndex)
 {
+	// The bound inventory owns the slots; its change event refreshes this one
+	if (BoundInventory)
+	{
+		const int32 Quantity = BoundInventory->GetItemAtSlot(SlotIndex).Quantity;
+		return Quantity > 0 && BoundInventory->RemoveItemFromSlot(SlotIndex, Quantity);
+	}
+
 	if (SlotIndex >= 0 && SlotIndex < InventoryItems.Num())
 	{
 		FInventoryItem EmptySlot;
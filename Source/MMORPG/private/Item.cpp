@@ -10,7 +10,6 @@ UItem::UItem()
 	Weight = 0.0f;
 	Value = 0;
 	MaxStackSize = 1;
-	CurrentStackSize = 1;
 	bIsStackable = false;
 }
 
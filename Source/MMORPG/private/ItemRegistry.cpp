@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ItemRegistry.h"
+#include "Item.h"
+#include "Engine/Engine.h"
+
+void UItemRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (!ItemDefinitionTable.IsNull())
+	{
+		LoadDefinitions(ItemDefinitionTable.LoadSynchronous());
+	}
+}
+
+void UItemRegistry::LoadDefinitions(UDataTable* DefinitionTable)
+{
+	if (!DefinitionTable)
+	{
+		return;
+	}
+
+	DefinitionTable->ForeachRow<FItemDefinitionRow>(TEXT("UItemRegistry::LoadDefinitions"),
+		[this](const FName& RowName, const FItemDefinitionRow& Row)
+		{
+			UClass* ItemClass = Row.ItemClass ? Row.ItemClass.Get() : UItem::StaticClass();
+			UItem* Item = NewObject<UItem>(this, ItemClass, RowName);
+			Item->ItemID = Row.ItemID;
+			Item->ItemName = Row.ItemName;
+			Item->Description = Row.Description;
+			Item->Weight = Row.Weight;
+			Item->Value = Row.Value;
+			Item->MaxStackSize = Row.MaxStackSize;
+			Item->bIsStackable = Row.bIsStackable;
+			RegisterItem(Item);
+		});
+}
+
+UItem* UItemRegistry::RegisterItem(UItem* Item)
+{
+	if (!Item)
+	{
+		return nullptr;
+	}
+
+	if (DefinitionIndexByID.Contains(Item->ItemID))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Item %d already has a definition; %s was not registered"), Item->ItemID, *Item->GetName());
+		return nullptr;
+	}
+
+	UItem* Definition = Item->GetOuter() == this ? Item : DuplicateObject<UItem>(Item, this);
+	DefinitionIndexByID.Add(Definition->ItemID, Definitions.Add(Definition));
+	HotData.Add(MakeHotData(Definition));
+	return Definition;
+}
+
+UItem* UItemRegistry::FindItemByID(int32 ItemID) const
+{
+	const int32* Index = DefinitionIndexByID.Find(ItemID);
+	return Index ? Definitions[*Index] : nullptr;
+}
+
+bool UItemRegistry::IsDefinition(const UItem* Item) const
+{
+	return Item && FindItemByID(Item->ItemID) == Item;
+}
+
+const FItemHotData* UItemRegistry::FindHotData(int32 ItemID) const
+{
+	const int32* Index = DefinitionIndexByID.Find(ItemID);
+	return Index ? &HotData[*Index] : nullptr;
+}
+
+UItemRegistry* UItemRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UItemRegistry>() : nullptr;
+}
+
+FItemHotData UItemRegistry::MakeHotData(const UItem* Item)
+{
+	FItemHotData Data;
+	Data.Weight = Item->Weight;
+	Data.StackLimit = Item->bIsStackable ? FMath::Max(1, Item->MaxStackSize) : 1;
+	return Data;
+}
@@ -2,41 +2,39 @@
 
 #include "PlayerAttributesComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 UPlayerAttributesComponent::UPlayerAttributesComponent()
 {
-	PrimaryComponentTick.bCanEverTick = false;
-	SetIsReplicatedComponent(true);
-
-	// Initialize default values
+	// Initialize default values; HP, Mana and Stamina default to 100 of 100 in the resource attributes
 	CurrentXP = 0.0f;
 	Credits = 0;
 
-	// Base max values
-	BaseMaxHP = 100.0f;
-	BaseMaxMana = 100.0f;
-	BaseMaxStamina = 100.0f;
-
-	// Current values start at max
-	CurrentHP = BaseMaxHP;
-	CurrentMana = BaseMaxMana;
-	CurrentStamina = BaseMaxStamina;
-
-	// Initialize equipment modifiers
-	EquipmentMaxHPModifier = 0.0f;
-	EquipmentMaxManaModifier = 0.0f;
-	EquipmentMaxStaminaModifier = 0.0f;
-
-	// Calculate initial max values
-	MaxHP = BaseMaxHP;
-	MaxMana = BaseMaxMana;
-	MaxStamina = BaseMaxStamina;
+	// Other players only draw bars and nameplates from a player's vitals
+	bQuantizeForNonOwners = true;
 }
 
-void UPlayerAttributesComponent::BeginPlay()
+void UPlayerAttributesComponent::PostLoad()
 {
-	Super::BeginPlay();
-	RecalculateMaxValues();
+	Super::PostLoad();
+
+	// Blueprints and placed components saved with the old base maximums keep them; values are also the
+	// starting values, since BeginPlay fills every resource to its maximum
+	float* const SavedBaseMaxes[] = { &BaseMaxHP_DEPRECATED, &BaseMaxMana_DEPRECATED, &BaseMaxStamina_DEPRECATED };
+	const EResourceType ResourceTypes[] = { EResourceType::Health, EResourceType::Mana, EResourceType::Stamina };
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(SavedBaseMaxes); ++Index)
+	{
+		float& SavedBaseMax = *SavedBaseMaxes[Index];
+		FResourceAttribute* Attribute = FindAttribute(ResourceTypes[Index]);
+		if (SavedBaseMax >= 0.0f && Attribute)
+		{
+			Attribute->BaseMax = SavedBaseMax;
+			Attribute->Current = SavedBaseMax;
+		}
+
+		// Cleared so components created from this one do not apply it again over their own edits
+		SavedBaseMax = -1.0f;
+	}
 }
 
 void UPlayerAttributesComponent::AddXP(float Amount)
@@ -44,22 +42,29 @@ void UPlayerAttributesComponent::AddXP(float Amount)
 	if (Amount > 0.0f)
 	{
 		CurrentXP += Amount;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UPlayerAttributesComponent, CurrentXP, this);
 	}
 }
 
 void UPlayerAttributesComponent::ModifyHP(float Amount)
 {
-	CurrentHP = FMath::Clamp(CurrentHP + Amount, 0.0f, MaxHP);
+	FResourceAmounts Deltas;
+	Deltas.Set(EResourceType::Health, Amount);
+	ApplyResourceDeltas(Deltas, false);
 }
 
 void UPlayerAttributesComponent::ModifyMana(float Amount)
 {
-	CurrentMana = FMath::Clamp(CurrentMana + Amount, 0.0f, MaxMana);
+	FResourceAmounts Deltas;
+	Deltas.Set(EResourceType::Mana, Amount);
+	ApplyResourceDeltas(Deltas, false);
 }
 
 void UPlayerAttributesComponent::ModifyStamina(float Amount)
 {
-	CurrentStamina = FMath::Clamp(CurrentStamina + Amount, 0.0f, MaxStamina);
+	FResourceAmounts Deltas;
+	Deltas.Set(EResourceType::Stamina, Amount);
+	ApplyResourceDeltas(Deltas, false);
 }
 
 void UPlayerAttributesComponent::AddCredits(int32 Amount)
@@ -67,6 +72,7 @@ void UPlayerAttributesComponent::AddCredits(int32 Amount)
 	if (Amount > 0)
 	{
 		Credits += Amount;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UPlayerAttributesComponent, Credits, this);
 	}
 }
 
@@ -75,6 +81,7 @@ bool UPlayerAttributesComponent::SpendCredits(int32 Amount)
 	if (Amount > 0 && Credits >= Amount)
 	{
 		Credits -= Amount;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UPlayerAttributesComponent, Credits, this);
 		return true;
 	}
 	return false;
@@ -82,41 +89,27 @@ bool UPlayerAttributesComponent::SpendCredits(int32 Amount)
 
 void UPlayerAttributesComponent::ApplyMaxHPModifier(float Modifier)
 {
-	EquipmentMaxHPModifier = Modifier;
-	RecalculateMaxValues();
+	SetMaxResourceModifier(EResourceType::Health, Modifier);
 }
 
 void UPlayerAttributesComponent::ApplyMaxManaModifier(float Modifier)
 {
-	EquipmentMaxManaModifier = Modifier;
-	RecalculateMaxValues();
+	SetMaxResourceModifier(EResourceType::Mana, Modifier);
 }
 
 void UPlayerAttributesComponent::ApplyMaxStaminaModifier(float Modifier)
 {
-	EquipmentMaxStaminaModifier = Modifier;
-	RecalculateMaxValues();
-}
-
-void UPlayerAttributesComponent::RecalculateMaxValues()
-{
-	MaxHP = BaseMaxHP + EquipmentMaxHPModifier;
-	MaxMana = BaseMaxMana + EquipmentMaxManaModifier;
-	MaxStamina = BaseMaxStamina + EquipmentMaxStaminaModifier;
-
-	// Clamp current values to new max values
-	CurrentHP = FMath::Min(CurrentHP, MaxHP);
-	CurrentMana = FMath::Min(CurrentMana, MaxMana);
-	CurrentStamina = FMath::Min(CurrentStamina, MaxStamina);
+	SetMaxResourceModifier(EResourceType::Stamina, Modifier);
 }
 
 void UPlayerAttributesComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UPlayerAttributesComponent, CurrentXP);
-	DOREPLIFETIME(UPlayerAttributesComponent, CurrentHP);
-	DOREPLIFETIME(UPlayerAttributesComponent, CurrentMana);
-	DOREPLIFETIME(UPlayerAttributesComponent, CurrentStamina);
-	DOREPLIFETIME(UPlayerAttributesComponent, Credits);
+	// Only the owner's UI shows XP and credits
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UPlayerAttributesComponent, CurrentXP, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UPlayerAttributesComponent, Credits, Params);
 }
@@ -1,70 +1,113 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ResourceComponent.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+namespace
+{
+	// Float rounding can leave a resource a hair short of a threshold when its timer fires; the retry waits at least this long
+	constexpr float MinThresholdTimerDelay = 0.01f;
+}
+
+bool FQuantizedResourceFractions::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	for (uint16& Step : Steps)
+	{
+		uint32 Value = Step;
+		Ar.SerializeBits(&Value, NumBits);
+		Step = static_cast<uint16>(FMath::Min(Value, MaxSteps));
+	}
+
+	bOutSuccess = true;
+	return true;
+}
 
 UResourceComponent::UResourceComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedComponent(true);
 
-	// Default values
-	MaxHealth = 100.0f;
-	CurrentHealth = MaxHealth;
-	MaxMana = 100.0f;
-	CurrentMana = MaxMana;
-	MaxStamina = 100.0f;
-	CurrentStamina = MaxStamina;
+	// One entry per resource type, each defaulting to 100 of 100
+	Attributes.SetNum(NumCombatResourceTypes);
+	SimulatedResources.SetNum(NumCombatResourceTypes);
 }
 
 void UResourceComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Initialize current values to max
-	CurrentHealth = MaxHealth;
-	CurrentMana = MaxMana;
-	CurrentStamina = MaxStamina;
-}
+	const bool bHasAuthority = GetOwnerRole() == ROLE_Authority;
+	const double Now = GetWorldTime();
+	for (FResourceAttribute& Attribute : Attributes)
+	{
+		// Initialize current values to max; clients take theirs from replication
+		if (bHasAuthority)
+		{
+			Attribute.Current = Attribute.GetMax();
+		}
+		Attribute.UpdateTime = Now;
+	}
+	if (bHasAuthority)
+	{
+		MarkAttributesDirty();
+	}
 
-float UResourceComponent::GetCurrentResource(EResourceType ResourceType) const
-{
-	const float* ResourceValue = GetResourceRef(ResourceType);
-	return ResourceValue ? *ResourceValue : 0.0f;
+	// Draining resources may already be heading for a threshold
+	ScheduleThresholdTimer(EResourceType::Health);
+	ScheduleThresholdTimer(EResourceType::Mana);
+	ScheduleThresholdTimer(EResourceType::Stamina);
 }
 
-float UResourceComponent::GetMaxResource(EResourceType ResourceType) const
+void UResourceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	const float* MaxValue = GetMaxResourceRef(ResourceType);
-	return MaxValue ? *MaxValue : 0.0f;
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearAllTimersForObject(this);
+	}
+	ThresholdTimerHandles.Reset();
+
+	Super::EndPlay(EndPlayReason);
 }
 
-bool UResourceComponent::ConsumeResource(EResourceType ResourceType, float Amount)
+float UResourceComponent::GetCurrentResource(EResourceType ResourceType) const
 {
-	if (!HasEnoughResource(ResourceType, Amount))
+	const FResourceAttribute* Attribute = FindAttribute(ResourceType);
+	if (!Attribute)
 	{
-		return false;
+		return 0.0f;
 	}
 
-	float* ResourceValue = GetResourceRef(ResourceType);
-	if (ResourceValue)
+	// The stored value is as of the last update; add what has regenerated since
+	if (Attribute->RegenRate == 0.0f)
 	{
-		*ResourceValue = FMath::Max(0.0f, *ResourceValue - Amount);
-		OnResourceChanged.Broadcast(ResourceType, *ResourceValue, GetMaxResource(ResourceType));
-		return true;
+		return Attribute->Current;
 	}
 
-	return false;
+	const float Elapsed = static_cast<float>(GetWorldTime() - Attribute->UpdateTime);
+	return FMath::Clamp(Attribute->Current + Attribute->RegenRate * Elapsed, 0.0f, Attribute->GetMax());
 }
 
-void UResourceComponent::RestoreResource(EResourceType ResourceType, float Amount)
+float UResourceComponent::GetMaxResource(EResourceType ResourceType) const
 {
-	float* ResourceValue = GetResourceRef(ResourceType);
-	float MaxValue = GetMaxResource(ResourceType);
+	const FResourceAttribute* Attribute = FindAttribute(ResourceType);
+	return Attribute ? Attribute->GetMax() : 0.0f;
+}
 
-	if (ResourceValue)
-	{
-		*ResourceValue = FMath::Min(MaxValue, *ResourceValue + Amount);
-		OnResourceChanged.Broadcast(ResourceType, *ResourceValue, MaxValue);
-	}
+bool UResourceComponent::ConsumeResource(EResourceType ResourceType, float Amount)
+{
+	FResourceAmounts Deltas;
+	Deltas.Set(ResourceType, -Amount);
+	return FindAttribute(ResourceType) && ApplyResourceDeltas(Deltas, true);
+}
+
+void UResourceComponent::RestoreResource(EResourceType ResourceType, float Amount)
+{
+	FResourceAmounts Deltas;
+	Deltas.Set(ResourceType, Amount);
+	ApplyResourceDeltas(Deltas, false);
 }
 
 bool UResourceComponent::HasEnoughResource(EResourceType ResourceType, float Amount) const
@@ -86,77 +129,396 @@ bool UResourceComponent::HasEnoughResources(const TArray<FResourceCost>& Costs)
 
 bool UResourceComponent::ConsumeResources(const TArray<FResourceCost>& Costs)
 {
-	// First check if all resources are available
-	if (!HasEnoughResources(Costs))
+	FResourceAmounts Deltas;
+	for (const FResourceCost& Cost : Costs)
 	{
-		return false;
+		Deltas.Add(Cost.ResourceType, -Cost.Amount);
 	}
+	return ApplyResourceDeltas(Deltas, true);
+}
 
-	// Consume all resources
-	for (const FResourceCost& Cost : Costs)
+void UResourceComponent::RestoreResources(const TArray<FResourceCost>& Amounts)
+{
+	FResourceAmounts Deltas;
+	for (const FResourceCost& Amount : Amounts)
 	{
-		ConsumeResource(Cost.ResourceType, Cost.Amount);
+		Deltas.Add(Amount.ResourceType, Amount.Amount);
 	}
+	ApplyResourceDeltas(Deltas, false);
+}
 
+bool UResourceComponent::ApplyResourceDeltas(const FResourceAmounts& Deltas, bool bRequireEnough)
+{
+	// Validate everything before changing anything
+	if (bRequireEnough)
+	{
+		for (int32 Index = 0; Index < NumCombatResourceTypes; ++Index)
+		{
+			const EResourceType ResourceType = static_cast<EResourceType>(Index);
+			const float Delta = Deltas.Get(ResourceType);
+			if (Delta < 0.0f && GetCurrentResource(ResourceType) < -Delta)
+			{
+				return false;
+			}
+		}
+	}
+
+	int32 ChangedMask = 0;
+	FResourceAmounts PreviousValues;
+	FResourceAmounts PreviousMaxes;
+	for (int32 Index = 0; Index < NumCombatResourceTypes; ++Index)
+	{
+		const EResourceType ResourceType = static_cast<EResourceType>(Index);
+		const float Delta = Deltas.Get(ResourceType);
+		FResourceAttribute* Attribute = FindAttribute(ResourceType);
+		if (Delta == 0.0f || !Attribute)
+		{
+			continue;
+		}
+
+		SettleResource(ResourceType);
+
+		const float PreviousValue = Attribute->Current;
+		Attribute->Current = FMath::Clamp(PreviousValue + Delta, 0.0f, Attribute->GetMax());
+		if (Attribute->Current != PreviousValue)
+		{
+			ChangedMask |= GetResourceBit(ResourceType);
+			PreviousValues.Set(ResourceType, PreviousValue);
+			PreviousMaxes.Set(ResourceType, Attribute->GetMax());
+		}
+	}
+
+	if (ChangedMask != 0)
+	{
+		MarkAttributesDirty();
+		BroadcastResourcesChanged(ChangedMask, PreviousValues, PreviousMaxes);
+	}
 	return true;
 }
 
-float* UResourceComponent::GetResourceRef(EResourceType ResourceType)
+float UResourceComponent::GetResourceRegenRate(EResourceType ResourceType) const
+{
+	const FResourceAttribute* Attribute = FindAttribute(ResourceType);
+	return Attribute ? Attribute->RegenRate : 0.0f;
+}
+
+void UResourceComponent::SetResourceRegenRate(EResourceType ResourceType, float RatePerSecond)
+{
+	FResourceAttribute* Attribute = FindAttribute(ResourceType);
+	if (!Attribute)
+	{
+		return;
+	}
+
+	// Bank what the old rate produced before the new one takes over
+	SettleResource(ResourceType);
+	Attribute->RegenRate = RatePerSecond;
+	MarkAttributesDirty();
+	ScheduleThresholdTimer(ResourceType);
+}
+
+void UResourceComponent::SetMaxResourceModifier(EResourceType ResourceType, float Modifier)
+{
+	FResourceAttribute* Attribute = FindAttribute(ResourceType);
+	if (!Attribute || Attribute->Modifier == Modifier)
+	{
+		return;
+	}
+
+	SettleResource(ResourceType);
+
+	FResourceAmounts PreviousValues;
+	FResourceAmounts PreviousMaxes;
+	PreviousValues.Set(ResourceType, Attribute->Current);
+	PreviousMaxes.Set(ResourceType, Attribute->GetMax());
+	Attribute->Modifier = Modifier;
+	Attribute->Current = FMath::Min(Attribute->Current, Attribute->GetMax());
+	MarkAttributesDirty();
+
+	// A new maximum moves the thresholds too, so a full resource stops being full when the maximum grows
+	BroadcastResourcesChanged(GetResourceBit(ResourceType), PreviousValues, PreviousMaxes);
+}
+
+void UResourceComponent::AddResourceThreshold(EResourceType ResourceType, float Fraction)
+{
+	FResourceThreshold& Threshold = ResourceThresholds.AddDefaulted_GetRef();
+	Threshold.ResourceType = ResourceType;
+	Threshold.Fraction = FMath::Clamp(Fraction, 0.0f, 1.0f);
+
+	ScheduleThresholdTimer(ResourceType);
+}
+
+void UResourceComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Everything here is marked dirty where it changes, so idle players cost no comparisons per net update
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = bQuantizeForNonOwners ? COND_OwnerOnly : COND_None;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UResourceComponent, Attributes, Params);
+
+	Params.Condition = bQuantizeForNonOwners ? COND_SkipOwner : COND_Never;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UResourceComponent, QuantizedFractions, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UResourceComponent, SimulatedResources, Params);
+}
+
+void UResourceComponent::OnRep_Attributes(const TArray<FResourceAttribute>& PreviousAttributes)
+{
+	// Received values are as of now on this machine; regeneration continues locally from here
+	const double Now = GetWorldTime();
+	int32 ChangedMask = 0;
+	FResourceAmounts PreviousValues;
+	FResourceAmounts PreviousMaxes;
+	for (int32 Index = 0; Index < Attributes.Num(); ++Index)
+	{
+		const EResourceType ResourceType = static_cast<EResourceType>(Index);
+		FResourceAttribute& Attribute = Attributes[Index];
+		Attribute.UpdateTime = Now;
+
+		if (!PreviousAttributes.IsValidIndex(Index))
+		{
+			ChangedMask |= GetResourceBit(ResourceType);
+			PreviousValues.Set(ResourceType, Attribute.Current);
+			PreviousMaxes.Set(ResourceType, Attribute.GetMax());
+			continue;
+		}
+
+		const FResourceAttribute& Previous = PreviousAttributes[Index];
+		if (Previous.Current != Attribute.Current || Previous.GetMax() != Attribute.GetMax())
+		{
+			ChangedMask |= GetResourceBit(ResourceType);
+			PreviousValues.Set(ResourceType, Previous.RegenRate != 0.0f
+				? FMath::Clamp(Previous.Current + Previous.RegenRate * static_cast<float>(Now - Previous.UpdateTime), 0.0f, Previous.GetMax())
+				: Previous.Current);
+			PreviousMaxes.Set(ResourceType, Previous.GetMax());
+		}
+		else
+		{
+			// A new regeneration rate alone still moves the next threshold
+			ScheduleThresholdTimer(ResourceType);
+		}
+	}
+
+	if (ChangedMask != 0)
+	{
+		BroadcastResourcesChanged(ChangedMask, PreviousValues, PreviousMaxes);
+	}
+}
+
+void UResourceComponent::OnRep_SimulatedResources()
 {
-	switch (ResourceType)
+	// Both halves of the view may arrive in one update; each rebuild uses whatever has arrived so far
+	const double Now = GetWorldTime();
+	int32 ChangedMask = 0;
+	FResourceAmounts PreviousValues;
+	FResourceAmounts PreviousMaxes;
+	for (int32 Index = 0; Index < Attributes.Num() && Index < SimulatedResources.Num(); ++Index)
 	{
-	case EResourceType::Health:
-		return &CurrentHealth;
-	case EResourceType::Mana:
-		return &CurrentMana;
-	case EResourceType::Stamina:
-		return &CurrentStamina;
-	default:
-		return nullptr;
+		const EResourceType ResourceType = static_cast<EResourceType>(Index);
+		const FSimulatedResource& Simulated = SimulatedResources[Index];
+		FResourceAttribute& Attribute = Attributes[Index];
+		const float PreviousValue = GetCurrentResource(ResourceType);
+		const float PreviousMax = Attribute.GetMax();
+		const float PreviousRegenRate = Attribute.RegenRate;
+
+		Attribute.BaseMax = Simulated.Max;
+		Attribute.Modifier = 0.0f;
+		Attribute.RegenRate = Simulated.RegenRate;
+		Attribute.Current = QuantizedFractions.GetFraction(Index) * Simulated.Max;
+		Attribute.UpdateTime = Now;
+
+		if (Attribute.Current != PreviousValue || Attribute.GetMax() != PreviousMax)
+		{
+			ChangedMask |= GetResourceBit(ResourceType);
+			PreviousValues.Set(ResourceType, PreviousValue);
+			PreviousMaxes.Set(ResourceType, PreviousMax);
+		}
+		else if (Attribute.RegenRate != PreviousRegenRate)
+		{
+			ScheduleThresholdTimer(ResourceType);
+		}
+	}
+
+	if (ChangedMask != 0)
+	{
+		BroadcastResourcesChanged(ChangedMask, PreviousValues, PreviousMaxes);
 	}
 }
 
-const float* UResourceComponent::GetResourceRef(EResourceType ResourceType) const
+void UResourceComponent::MarkAttributesDirty()
 {
-	switch (ResourceType)
+	MARK_PROPERTY_DIRTY_FROM_NAME(UResourceComponent, Attributes, this);
+
+	if (!bQuantizeForNonOwners || GetOwnerRole() != ROLE_Authority)
 	{
-	case EResourceType::Health:
-		return &CurrentHealth;
-	case EResourceType::Mana:
-		return &CurrentMana;
-	case EResourceType::Stamina:
-		return &CurrentStamina;
-	default:
-		return nullptr;
+		return;
+	}
+
+	// Non-owners are only sent a change they could see: a 0.1% step or a new maximum or rate
+	FQuantizedResourceFractions Fractions;
+	bool bSimulatedChanged = false;
+	for (int32 Index = 0; Index < Attributes.Num() && Index < SimulatedResources.Num(); ++Index)
+	{
+		const FResourceAttribute& Attribute = Attributes[Index];
+		const float MaxValue = Attribute.GetMax();
+		Fractions.SetFraction(Index, MaxValue > 0.0f ? GetCurrentResource(static_cast<EResourceType>(Index)) / MaxValue : 0.0f);
+
+		FSimulatedResource& Simulated = SimulatedResources[Index];
+		if (Simulated.Max != MaxValue || Simulated.RegenRate != Attribute.RegenRate)
+		{
+			Simulated.Max = MaxValue;
+			Simulated.RegenRate = Attribute.RegenRate;
+			bSimulatedChanged = true;
+		}
+	}
+
+	if (!(Fractions == QuantizedFractions))
+	{
+		QuantizedFractions = Fractions;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UResourceComponent, QuantizedFractions, this);
+	}
+	if (bSimulatedChanged)
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(UResourceComponent, SimulatedResources, this);
+	}
+}
+
+void UResourceComponent::BroadcastResourcesChanged(int32 ChangedMask, const FResourceAmounts& PreviousValues, const FResourceAmounts& PreviousMaxes)
+{
+	OnResourcesChanged.Broadcast(ChangedMask);
+
+	for (int32 Index = 0; Index < NumCombatResourceTypes; ++Index)
+	{
+		const EResourceType ResourceType = static_cast<EResourceType>(Index);
+		if (!IsResourceInMask(ChangedMask, ResourceType))
+		{
+			continue;
+		}
+
+		const float CurrentValue = GetCurrentResource(ResourceType);
+		OnResourceChanged.Broadcast(ResourceType, CurrentValue, GetMaxResource(ResourceType));
+		NotifyThresholdsCrossed(ResourceType, PreviousValues.Get(ResourceType), PreviousMaxes.Get(ResourceType), CurrentValue);
+		ScheduleThresholdTimer(ResourceType);
 	}
 }
 
-float* UResourceComponent::GetMaxResourceRef(EResourceType ResourceType)
+void UResourceComponent::SettleResource(EResourceType ResourceType)
 {
-	switch (ResourceType)
+	FResourceAttribute* Attribute = FindAttribute(ResourceType);
+	if (!Attribute)
 	{
-	case EResourceType::Health:
-		return &MaxHealth;
-	case EResourceType::Mana:
-		return &MaxMana;
-	case EResourceType::Stamina:
-		return &MaxStamina;
-	default:
-		return nullptr;
+		return;
 	}
+
+	const float PreviousValue = Attribute->Current;
+	const float CurrentValue = GetCurrentResource(ResourceType);
+	Attribute->Current = CurrentValue;
+	Attribute->UpdateTime = GetWorldTime();
+
+	// Normally the threshold timer already reported these; this covers worlds without timers
+	NotifyThresholdsCrossed(ResourceType, PreviousValue, Attribute->GetMax(), CurrentValue);
 }
 
-const float* UResourceComponent::GetMaxResourceRef(EResourceType ResourceType) const
+void UResourceComponent::NotifyThresholdsCrossed(EResourceType ResourceType, float PreviousValue, float PreviousMax, float CurrentValue)
 {
-	switch (ResourceType)
+	const float MaxValue = GetMaxResource(ResourceType);
+	if (PreviousValue == CurrentValue && PreviousMax == MaxValue)
 	{
-	case EResourceType::Health:
-		return &MaxHealth;
-	case EResourceType::Mana:
-		return &MaxMana;
-	case EResourceType::Stamina:
-		return &MaxStamina;
-	default:
-		return nullptr;
+		return;
 	}
+
+	for (const FResourceThreshold& Threshold : ResourceThresholds)
+	{
+		if (Threshold.ResourceType != ResourceType)
+		{
+			continue;
+		}
+
+		const bool bWasAbove = PreviousValue >= Threshold.Fraction * PreviousMax;
+		const bool bIsAbove = CurrentValue >= Threshold.Fraction * MaxValue;
+		if (!bWasAbove && bIsAbove)
+		{
+			OnResourceThresholdCrossed.Broadcast(ResourceType, Threshold.Fraction, true);
+		}
+		else if (bWasAbove && !bIsAbove)
+		{
+			OnResourceThresholdCrossed.Broadcast(ResourceType, Threshold.Fraction, false);
+		}
+	}
+}
+
+void UResourceComponent::ScheduleThresholdTimer(EResourceType ResourceType)
+{
+	UWorld* World = GetWorld();
+	if (!World || !HasBegunPlay())
+	{
+		return;
+	}
+
+	FTimerManager& TimerManager = World->GetTimerManager();
+	if (FTimerHandle* ExistingHandle = ThresholdTimerHandles.Find(ResourceType))
+	{
+		TimerManager.ClearTimer(*ExistingHandle);
+	}
+
+	const float RegenRate = GetResourceRegenRate(ResourceType);
+	if (RegenRate == 0.0f)
+	{
+		return;
+	}
+
+	// Regeneration is linear, so the next crossing time is exact
+	const float CurrentValue = GetCurrentResource(ResourceType);
+	const float MaxValue = GetMaxResource(ResourceType);
+	float Delay = MAX_flt;
+	for (const FResourceThreshold& Threshold : ResourceThresholds)
+	{
+		if (Threshold.ResourceType != ResourceType)
+		{
+			continue;
+		}
+
+		const float ThresholdValue = Threshold.Fraction * MaxValue;
+		if (RegenRate > 0.0f && CurrentValue < ThresholdValue)
+		{
+			Delay = FMath::Min(Delay, (ThresholdValue - CurrentValue) / RegenRate);
+		}
+		else if (RegenRate < 0.0f && CurrentValue >= ThresholdValue && ThresholdValue > 0.0f)
+		{
+			Delay = FMath::Min(Delay, (CurrentValue - ThresholdValue) / -RegenRate);
+		}
+	}
+
+	if (Delay < MAX_flt)
+	{
+		TimerManager.SetTimer(ThresholdTimerHandles.FindOrAdd(ResourceType),
+			FTimerDelegate::CreateUObject(this, &UResourceComponent::HandleThresholdTimer, ResourceType),
+			FMath::Max(Delay, MinThresholdTimerDelay), false);
+	}
+}
+
+void UResourceComponent::HandleThresholdTimer(EResourceType ResourceType)
+{
+	SettleResource(ResourceType);
+	MarkAttributesDirty();
+	ScheduleThresholdTimer(ResourceType);
+}
+
+double UResourceComponent::GetWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+FResourceAttribute* UResourceComponent::FindAttribute(EResourceType ResourceType)
+{
+	const int32 Index = static_cast<int32>(ResourceType);
+	return Attributes.IsValidIndex(Index) ? &Attributes[Index] : nullptr;
+}
+
+const FResourceAttribute* UResourceComponent::FindAttribute(EResourceType ResourceType) const
+{
+	const int32 Index = static_cast<int32>(ResourceType);
+	return Attributes.IsValidIndex(Index) ? &Attributes[Index] : nullptr;
 }
@@ -1,7 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ResourceNodeActor.h"
-#include "TimerManager.h"
+#include "ResourceNodeSubsystem.h"
+#include "Engine/World.h"
 
 AResourceNodeActor::AResourceNodeActor()
 {
@@ -15,18 +16,25 @@ AResourceNodeActor::AResourceNodeActor()
 void AResourceNodeActor::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	// Start regeneration timer if enabled
-	if (bRegenerates && RegenerationInterval > 0.0f)
+
+	// Hand the node's state to the subsystem, which regenerates it without a timer per node
+	NodeSubsystem = GetWorld()->GetSubsystem<UResourceNodeSubsystem>();
+	if (NodeSubsystem)
+	{
+		NodeIndex = NodeSubsystem->RegisterNode(this);
+	}
+}
+
+void AResourceNodeActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (NodeSubsystem)
 	{
-		GetWorldTimerManager().SetTimer(
-			RegenerationTimerHandle,
-			this,
-			&AResourceNodeActor::RegenerateResources,
-			RegenerationInterval,
-			true
-		);
+		NodeSubsystem->UnregisterNode(NodeIndex);
+		NodeSubsystem = nullptr;
+		NodeIndex = INDEX_NONE;
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 int32 AResourceNodeActor::GatherResource(int32 AmountToGather)
@@ -36,24 +44,38 @@ int32 AResourceNodeActor::GatherResource(int32 AmountToGather)
 		return 0;
 	}
 
+	if (NodeSubsystem)
+	{
+		return NodeSubsystem->Gather(NodeIndex, AmountToGather);
+	}
+
 	// Calculate the actual amount that can be gathered
-	int32 ActualAmount = FMath::Min(AmountToGather, CurrentQuantity);
-	
+	int32 ActualAmount = FMath::Min(AmountToGather, StartingQuantity);
+
 	// Reduce the current quantity
-	CurrentQuantity -= ActualAmount;
+	StartingQuantity -= ActualAmount;
 
 	return ActualAmount;
 }
 
 bool AResourceNodeActor::HasResourcesAvailable() const
 {
-	return CurrentQuantity > 0;
+	return GetRemainingResources() > 0;
 }
 
-void AResourceNodeActor::RegenerateResources()
+int32 AResourceNodeActor::GetRemainingResources() const
 {
-	if (CurrentQuantity < MaxQuantity)
+	// Outside of play there is no subsystem, and the configured quantity is the whole story
+	return NodeSubsystem ? NodeSubsystem->GetQuantity(NodeIndex) : StartingQuantity;
+}
+
+void AResourceNodeActor::SetRemainingResources(int32 Quantity)
+{
+	if (NodeSubsystem)
 	{
-		CurrentQuantity = FMath::Min(CurrentQuantity + RegenerationAmount, MaxQuantity);
+		NodeSubsystem->SetQuantity(NodeIndex, Quantity);
+		return;
 	}
+
+	StartingQuantity = FMath::Clamp(Quantity, 0, MaxQuantity);
 }
@@ -0,0 +1,277 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ResourceNodeSubsystem.h"
+#include "Engine/World.h"
+
+int32 UResourceNodeSubsystem::RegisterNode(AResourceNodeActor* Node)
+{
+	if (!Node)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 NodeIndex;
+	if (FreeNodeIndices.Num() > 0)
+	{
+		NodeIndex = FreeNodeIndices.Pop(false);
+		Nodes[NodeIndex] = FResourceNodeState();
+	}
+	else
+	{
+		NodeIndex = Nodes.AddDefaulted();
+	}
+
+	FResourceNodeState& State = Nodes[NodeIndex];
+	State.Actor = Node;
+	State.bRegistered = true;
+	State.MaxQuantity = FMath::Max(0, Node->MaxQuantity);
+	State.Quantity = FMath::Clamp(Node->StartingQuantity, 0, State.MaxQuantity);
+	State.RegenStartTime = GetWorldTime();
+	if (Node->bRegenerates && Node->RegenerationInterval > 0.0f && Node->RegenerationAmount > 0)
+	{
+		State.RegenerationInterval = Node->RegenerationInterval;
+		State.RegenerationAmount = Node->RegenerationAmount;
+	}
+	++NumNodes;
+
+	// A node placed empty is already waiting to respawn, but has not been depleted by anyone
+	if (State.Quantity == 0)
+	{
+		State.bDepleted = true;
+		ScheduleRespawn(NodeIndex, State.RegenStartTime);
+	}
+	return NodeIndex;
+}
+
+void UResourceNodeSubsystem::UnregisterNode(int32 NodeIndex)
+{
+	if (!Nodes.IsValidIndex(NodeIndex) || !Nodes[NodeIndex].bRegistered)
+	{
+		return;
+	}
+
+	FResourceNodeState& State = Nodes[NodeIndex];
+	TimerWheel.Cancel(State.RespawnTimer);
+	State.Actor.Reset();
+	State.bRegistered = false;
+	FreeNodeIndices.Add(NodeIndex);
+	--NumNodes;
+}
+
+int32 UResourceNodeSubsystem::GetQuantity(int32 NodeIndex) const
+{
+	if (!Nodes.IsValidIndex(NodeIndex) || !Nodes[NodeIndex].bRegistered)
+	{
+		return 0;
+	}
+	return GetQuantityAt(Nodes[NodeIndex], GetWorldTime());
+}
+
+int32 UResourceNodeSubsystem::Gather(int32 NodeIndex, int32 AmountToGather)
+{
+	if (!Nodes.IsValidIndex(NodeIndex) || !Nodes[NodeIndex].bRegistered || AmountToGather <= 0)
+	{
+		return 0;
+	}
+
+	const double Now = GetWorldTime();
+	FResourceNodeState& State = Nodes[NodeIndex];
+	SettleNode(State, Now);
+
+	const int32 ActualAmount = FMath::Min(AmountToGather, State.Quantity);
+	if (ActualAmount <= 0)
+	{
+		return 0;
+	}
+
+	// The node regenerated since its respawn timer last came due; report the respawn before this gather
+	const bool bRespawned = State.bDepleted;
+	if (bRespawned)
+	{
+		TimerWheel.Cancel(State.RespawnTimer);
+		State.bDepleted = false;
+	}
+
+	State.Quantity -= ActualAmount;
+	const bool bDepleted = State.Quantity == 0;
+	if (bDepleted)
+	{
+		State.bDepleted = true;
+		ScheduleRespawn(NodeIndex, Now);
+	}
+
+	// State is final before any handler runs, and is not touched again in case a handler registers a node
+	AResourceNodeActor* Node = State.Actor.Get();
+	if (Node && bRespawned)
+	{
+		OnNodeRespawned.Broadcast(Node);
+		Node->OnRespawned.Broadcast(Node);
+	}
+	if (Node && bDepleted)
+	{
+		OnNodeDepleted.Broadcast(Node);
+		Node->OnDepleted.Broadcast(Node);
+	}
+	return ActualAmount;
+}
+
+void UResourceNodeSubsystem::SetQuantity(int32 NodeIndex, int32 Quantity)
+{
+	if (!Nodes.IsValidIndex(NodeIndex) || !Nodes[NodeIndex].bRegistered)
+	{
+		return;
+	}
+
+	// Settling first keeps the partial interval, so a node set below full regenerates on its usual schedule
+	const double Now = GetWorldTime();
+	FResourceNodeState& State = Nodes[NodeIndex];
+	SettleNode(State, Now);
+	State.Quantity = FMath::Clamp(Quantity, 0, State.MaxQuantity);
+
+	const bool bWasDepleted = State.bDepleted;
+	if (State.Quantity > 0)
+	{
+		// An empty node refilled by hand has respawned
+		if (bWasDepleted)
+		{
+			TimerWheel.Cancel(State.RespawnTimer);
+			FinishRespawn(NodeIndex);
+		}
+		return;
+	}
+
+	State.bDepleted = true;
+	ScheduleRespawn(NodeIndex, Now);
+	if (bWasDepleted)
+	{
+		return;
+	}
+
+	// State is final before any handler runs, as in Gather
+	if (AResourceNodeActor* Node = State.Actor.Get())
+	{
+		OnNodeDepleted.Broadcast(Node);
+		Node->OnDepleted.Broadcast(Node);
+	}
+}
+
+void UResourceNodeSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorldTime();
+	FiredTimers.Reset();
+	TimerWheel.Advance(static_cast<uint64>(Now / TimerResolution), FiredTimers);
+
+	for (const uint32 Payload : FiredTimers)
+	{
+		// An earlier handler may have unregistered the node, or a gather may have respawned it and rearmed the timer
+		const int32 NodeIndex = static_cast<int32>(Payload);
+		FResourceNodeState& State = Nodes[NodeIndex];
+		if (!State.bRegistered || !State.bDepleted || TimerWheel.IsPending(State.RespawnTimer))
+		{
+			continue;
+		}
+
+		SettleNode(State, Now);
+		if (State.Quantity > 0)
+		{
+			FinishRespawn(NodeIndex);
+		}
+		else
+		{
+			ScheduleRespawn(NodeIndex, Now);
+		}
+	}
+}
+
+TStatId UResourceNodeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceNodeSubsystem, STATGROUP_Tickables);
+}
+
+bool UResourceNodeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UResourceNodeSubsystem::GetQuantityAt(const FResourceNodeState& Node, double Now)
+{
+	if (Node.RegenerationAmount <= 0 || Node.Quantity >= Node.MaxQuantity)
+	{
+		return Node.Quantity;
+	}
+
+	const int64 Intervals = FMath::FloorToInt64((Now - Node.RegenStartTime) / Node.RegenerationInterval);
+	return static_cast<int32>(FMath::Min<int64>(Node.MaxQuantity, Node.Quantity + FMath::Max<int64>(0, Intervals) * Node.RegenerationAmount));
+}
+
+void UResourceNodeSubsystem::SettleNode(FResourceNodeState& Node, double Now)
+{
+	if (Node.RegenerationAmount <= 0)
+	{
+		return;
+	}
+
+	// A full node's clock restarts at the gather that takes it below full
+	if (Node.Quantity >= Node.MaxQuantity)
+	{
+		Node.RegenStartTime = Now;
+		return;
+	}
+
+	const int64 Intervals = FMath::FloorToInt64((Now - Node.RegenStartTime) / Node.RegenerationInterval);
+	if (Intervals <= 0)
+	{
+		return;
+	}
+
+	Node.Quantity = GetQuantityAt(Node, Now);
+	Node.RegenStartTime = Node.Quantity >= Node.MaxQuantity ? Now : Node.RegenStartTime + Intervals * Node.RegenerationInterval;
+}
+
+void UResourceNodeSubsystem::ScheduleRespawn(int32 NodeIndex, double Now)
+{
+	FResourceNodeState& State = Nodes[NodeIndex];
+	TimerWheel.Cancel(State.RespawnTimer);
+	if (State.RegenerationAmount <= 0 || State.MaxQuantity <= 0)
+	{
+		return;
+	}
+
+	// An idle wheel stops advancing, so catch it up before measuring the delay from its current tick;
+	// with nothing pending nothing fires, and FiredTimers may be mid-iteration in Tick
+	if (TimerWheel.Num() == 0)
+	{
+		TArray<uint32> NoTimers;
+		TimerWheel.Advance(static_cast<uint64>(Now / TimerResolution), NoTimers);
+	}
+
+	const double RespawnTime = State.RegenStartTime + State.RegenerationInterval;
+	const uint64 RespawnTick = SecondsToTicks(RespawnTime);
+	const uint64 CurrentTick = TimerWheel.GetCurrentTick();
+	State.RespawnTimer = TimerWheel.Schedule(RespawnTick > CurrentTick ? RespawnTick - CurrentTick : 1, static_cast<uint32>(NodeIndex));
+}
+
+void UResourceNodeSubsystem::FinishRespawn(int32 NodeIndex)
+{
+	FResourceNodeState& State = Nodes[NodeIndex];
+	State.bDepleted = false;
+
+	if (AResourceNodeActor* Node = State.Actor.Get())
+	{
+		OnNodeRespawned.Broadcast(Node);
+		Node->OnRespawned.Broadcast(Node);
+	}
+}
+
+double UResourceNodeSubsystem::GetWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+uint64 UResourceNodeSubsystem::SecondsToTicks(double Seconds)
+{
+	return static_cast<uint64>(FMath::Max<int64>(0, FMath::CeilToInt64(Seconds / TimerResolution)));
+}
@@ -0,0 +1,166 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "StatusEffectBenchmarkCommandlet.h"
+#include "StatusEffectSubsystem.h"
+#include "CombatCharacter.h"
+#include "CombatComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+namespace
+{
+	constexpr int32 NumEffects = 100000;
+	constexpr double FrameSeconds = 1.0 / 30.0;
+
+	// Same timings as typical DoTs and buffs: ticks every second, lasting 5 to 60 seconds
+	constexpr int32 PeriodTicks = static_cast<int32>(1.0 / UStatusEffectSubsystem::TimerResolution);
+	constexpr int32 MinDurationTicks = static_cast<int32>(5.0 / UStatusEffectSubsystem::TimerResolution);
+	constexpr int32 MaxDurationTicks = static_cast<int32>(60.0 / UStatusEffectSubsystem::TimerResolution);
+
+	// The idle check applies a 10 second effect after the world has run a minute with no effects at all
+	const FName IdleCheckEffect(TEXT("IdleCheck"));
+	constexpr float IdleCheckDuration = 10.0f;
+	constexpr float IdleCheckIdleSeconds = 60.0f;
+	constexpr int32 IdleCheckTrials = 5;
+	constexpr float IdleCheckTickRate = 30.0f;
+
+	uint32 MakePayload(int32 EffectIndex, bool bPeriodic)
+	{
+		return (static_cast<uint32>(EffectIndex) << 1) | (bPeriodic ? 1u : 0u);
+	}
+}
+
+void UStatusEffectBenchmarkCommandlet::RunScenarios()
+{
+	Effects.SetNum(NumEffects);
+	RunScenario(TEXT("Apply100k"), NumEffects,
+		[this](int32 EffectIndex)
+		{
+			StartEffect(EffectIndex);
+		});
+
+	// One operation is a server frame: every due expiry and tick is handled, and expired effects are reapplied
+	int64 TimersFired = 0;
+	int32 Frame = 0;
+	RunScenario(TEXT("Frame100k"), Iterations,
+		[this, &TimersFired, &Frame](int32)
+		{
+			++Frame;
+			FiredTimers.Reset();
+			TimerWheel.Advance(static_cast<uint64>(Frame * FrameSeconds / UStatusEffectSubsystem::TimerResolution), FiredTimers);
+			TimersFired += FiredTimers.Num();
+
+			for (const uint32 Payload : FiredTimers)
+			{
+				const int32 EffectIndex = static_cast<int32>(Payload >> 1);
+				if (Payload & 1u)
+				{
+					// The effect expired and restarted earlier in this batch, which already rearmed its tick
+					if (TimerWheel.IsPending(Effects[EffectIndex].PeriodTimer))
+					{
+						continue;
+					}
+
+					Effects[EffectIndex].PeriodTimer = TimerWheel.Schedule(PeriodTicks, MakePayload(EffectIndex, true));
+				}
+				else
+				{
+					StopEffect(EffectIndex);
+					StartEffect(EffectIndex);
+				}
+			}
+		});
+	AddResultMetric(TEXT("ActiveTimers"), TimerWheel.Num());
+	AddResultMetric(TEXT("TimersFiredPerFrame"), static_cast<double>(TimersFired) / Iterations);
+
+	// Reapplying a Refresh effect: cancel the expiry and schedule a new one
+	RunScenario(TEXT("Refresh"), Iterations,
+		[this](int32)
+		{
+			const int32 EffectIndex = Random.RandRange(0, NumEffects - 1);
+			FBenchmarkEffect& Effect = Effects[EffectIndex];
+			TimerWheel.Cancel(Effect.ExpiryTimer);
+			Effect.ExpiryTimer = TimerWheel.Schedule(Random.RandRange(MinDurationTicks, MaxDurationTicks), MakePayload(EffectIndex, false));
+		});
+
+	// Dispels and reapplications at full load
+	RunScenario(TEXT("RemoveApply"), Iterations,
+		[this](int32)
+		{
+			const int32 EffectIndex = Random.RandRange(0, NumEffects - 1);
+			StopEffect(EffectIndex);
+			StartEffect(EffectIndex);
+		});
+
+	RunApplyAfterIdle();
+}
+
+void UStatusEffectBenchmarkCommandlet::RunApplyAfterIdle()
+{
+	const FScopedFixedTimeStep FixedTimeStep(IdleCheckTickRate, false);
+	UWorld* World = CreateBenchmarkWorld(TEXT("StatusEffectIdleCheck"));
+	UStatusEffectSubsystem* StatusEffects = World->GetSubsystem<UStatusEffectSubsystem>();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ACombatCharacter* Character = World->SpawnActor<ACombatCharacter>(ACombatCharacter::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	Character->GetCharacterMovement()->DisableMovement();
+	UCombatComponent* Target = Character->FindComponentByClass<UCombatComponent>();
+
+	FStatusEffectDefinition Definition;
+	Definition.Duration = IdleCheckDuration;
+	Definition.TickInterval = 0.0f;
+	StatusEffects->RegisterEffect(IdleCheckEffect, Definition);
+
+	// One operation applies the effect and runs the world until it expires; the idle minute before it is setup
+	const float DeltaTime = 1.0f / IdleCheckTickRate;
+	int32 EarlyExpiries = 0;
+	double ShortestLifetime = MAX_dbl;
+	RunScenario(TEXT("ApplyAfterIdle"), IdleCheckTrials,
+		[World, DeltaTime](int32)
+		{
+			for (int32 Frame = 0; Frame < static_cast<int32>(IdleCheckIdleSeconds * IdleCheckTickRate); ++Frame)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+			}
+		},
+		[World, StatusEffects, Target, DeltaTime, &EarlyExpiries, &ShortestLifetime](int32)
+		{
+			const double AppliedAt = World->GetTimeSeconds();
+			StatusEffects->ApplyEffect(Target, IdleCheckEffect, nullptr);
+			while (StatusEffects->GetEffectStacks(Target, IdleCheckEffect) > 0 && World->GetTimeSeconds() - AppliedAt < 2.0 * IdleCheckDuration)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+			}
+
+			const double Lifetime = World->GetTimeSeconds() - AppliedAt;
+			ShortestLifetime = FMath::Min(ShortestLifetime, Lifetime);
+			if (Lifetime < IdleCheckDuration - UStatusEffectSubsystem::TimerResolution)
+			{
+				++EarlyExpiries;
+			}
+		});
+
+	if (EarlyExpiries > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%d of %d effects applied after an idle spell expired early; shortest lasted %.2f of %.2f seconds"),
+			EarlyExpiries, IdleCheckTrials, ShortestLifetime, IdleCheckDuration);
+	}
+	AddResultMetric(TEXT("EarlyExpiries"), EarlyExpiries);
+	AddResultMetric(TEXT("ShortestLifetimeSeconds"), ShortestLifetime);
+
+	DestroyBenchmarkWorld(World);
+}
+
+void UStatusEffectBenchmarkCommandlet::StartEffect(int32 EffectIndex)
+{
+	FBenchmarkEffect& Effect = Effects[EffectIndex];
+	Effect.ExpiryTimer = TimerWheel.Schedule(Random.RandRange(MinDurationTicks, MaxDurationTicks), MakePayload(EffectIndex, false));
+	Effect.PeriodTimer = TimerWheel.Schedule(PeriodTicks, MakePayload(EffectIndex, true));
+}
+
+void UStatusEffectBenchmarkCommandlet::StopEffect(int32 EffectIndex)
+{
+	TimerWheel.Cancel(Effects[EffectIndex].ExpiryTimer);
+	TimerWheel.Cancel(Effects[EffectIndex].PeriodTimer);
+}
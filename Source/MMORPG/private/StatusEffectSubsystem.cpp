@@ -0,0 +1,334 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "StatusEffectSubsystem.h"
+#include "CombatComponent.h"
+#include "ResourceComponent.h"
+#include "Engine/World.h"
+
+void UStatusEffectSubsystem::RegisterEffect(FName EffectName, const FStatusEffectDefinition& Definition)
+{
+	if (EffectName.IsNone())
+	{
+		return;
+	}
+
+	if (const int32* ExistingIndex = DefinitionIndexByName.Find(EffectName))
+	{
+		Definitions[*ExistingIndex] = Definition;
+		return;
+	}
+
+	DefinitionIndexByName.Add(EffectName, Definitions.Add(Definition));
+	DefinitionNames.Add(EffectName);
+}
+
+FStatusEffectHandle UStatusEffectSubsystem::ApplyEffect(UCombatComponent* Target, FName EffectName, AActor* EffectInstigator)
+{
+	const int32* DefinitionIndex = DefinitionIndexByName.Find(EffectName);
+	if (!Target || !DefinitionIndex)
+	{
+		return FStatusEffectHandle();
+	}
+
+	CatchUpIdleTimerWheel();
+
+	const FStatusEffectDefinition& Definition = Definitions[*DefinitionIndex];
+	const int32* FirstOnTarget = FirstEffectByTarget.Find(Target);
+
+	// A target carries a handful of effects, so finding an existing one is a short list walk
+	if (Definition.Stacking != EStatusEffectStacking::Independent && FirstOnTarget)
+	{
+		for (int32 Index = *FirstOnTarget; Index != INDEX_NONE; Index = Effects[Index].NextOnTarget)
+		{
+			FActiveStatusEffect& Existing = Effects[Index];
+			if (Existing.Definition != *DefinitionIndex)
+			{
+				continue;
+			}
+
+			if (Definition.Stacking != EStatusEffectStacking::Ignore)
+			{
+				Existing.Instigator = EffectInstigator;
+				RestartExpiry(Existing, Index);
+				if (Definition.Stacking == EStatusEffectStacking::Stack && Existing.Stacks < Definition.MaxStacks)
+				{
+					SetStacks(Index, Existing.Stacks + 1);
+				}
+			}
+			return MakeHandle(Index);
+		}
+	}
+
+	const int32 EffectIndex = AllocateEffect();
+	FActiveStatusEffect& Effect = Effects[EffectIndex];
+	Effect.Target = Target;
+	Effect.TargetKey = Target;
+	Effect.Instigator = EffectInstigator;
+	Effect.Definition = *DefinitionIndex;
+	Effect.Stacks = 0;
+
+	// Push onto the front of the target's list
+	Effect.PrevOnTarget = INDEX_NONE;
+	Effect.NextOnTarget = FirstOnTarget ? *FirstOnTarget : INDEX_NONE;
+	if (Effect.NextOnTarget != INDEX_NONE)
+	{
+		Effects[Effect.NextOnTarget].PrevOnTarget = EffectIndex;
+	}
+	FirstEffectByTarget.Add(Target, EffectIndex);
+
+	RestartExpiry(Effect, EffectIndex);
+	if (Definition.TickInterval > 0.0f)
+	{
+		Effect.PeriodTimer = TimerWheel.Schedule(SecondsToTicks(Definition.TickInterval), MakePayload(EffectIndex, true));
+	}
+
+	++NumActiveEffects;
+	SetStacks(EffectIndex, 1);
+	return MakeHandle(EffectIndex);
+}
+
+bool UStatusEffectSubsystem::RemoveEffect(FStatusEffectHandle Handle)
+{
+	if (!Effects.IsValidIndex(Handle.Index))
+	{
+		return false;
+	}
+
+	const FActiveStatusEffect& Effect = Effects[Handle.Index];
+	if (Effect.Definition == INDEX_NONE || Effect.Generation != Handle.Generation)
+	{
+		return false;
+	}
+
+	EndEffect(Handle.Index);
+	return true;
+}
+
+void UStatusEffectSubsystem::RemoveAllEffects(UCombatComponent* Target)
+{
+	while (const int32* FirstOnTarget = FirstEffectByTarget.Find(Target))
+	{
+		EndEffect(*FirstOnTarget);
+	}
+}
+
+int32 UStatusEffectSubsystem::GetEffectStacks(const UCombatComponent* Target, FName EffectName) const
+{
+	const int32* DefinitionIndex = DefinitionIndexByName.Find(EffectName);
+	const int32* FirstOnTarget = FirstEffectByTarget.Find(Target);
+	if (!DefinitionIndex || !FirstOnTarget)
+	{
+		return 0;
+	}
+
+	int32 Stacks = 0;
+	for (int32 Index = *FirstOnTarget; Index != INDEX_NONE; Index = Effects[Index].NextOnTarget)
+	{
+		if (Effects[Index].Definition == *DefinitionIndex)
+		{
+			Stacks += Effects[Index].Stacks;
+		}
+	}
+	return Stacks;
+}
+
+void UStatusEffectSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const uint64 ToTick = static_cast<uint64>(GetWorld()->GetTimeSeconds() / TimerResolution);
+	FiredTimers.Reset();
+	TimerWheel.Advance(ToTick, FiredTimers);
+
+	bHandlingTimers = true;
+	for (const uint32 Payload : FiredTimers)
+	{
+		const int32 EffectIndex = static_cast<int32>(Payload >> 1);
+		FActiveStatusEffect& Effect = Effects[EffectIndex];
+		if (Effect.Definition == INDEX_NONE)
+		{
+			continue;
+		}
+
+		// A handler earlier in the batch may have restarted this timer, which makes the fired one stale
+		if (Payload & 1u)
+		{
+			if (!TimerWheel.IsPending(Effect.PeriodTimer))
+			{
+				ApplyPeriodicTick(EffectIndex);
+			}
+		}
+		else if (!TimerWheel.IsPending(Effect.ExpiryTimer))
+		{
+			EndEffect(EffectIndex);
+		}
+	}
+	bHandlingTimers = false;
+
+	for (const int32 EffectIndex : DeferredFreeEffects)
+	{
+		Effects[EffectIndex].NextOnTarget = FirstFreeEffect;
+		FirstFreeEffect = EffectIndex;
+	}
+	DeferredFreeEffects.Reset();
+}
+
+TStatId UStatusEffectSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UStatusEffectSubsystem, STATGROUP_Tickables);
+}
+
+bool UStatusEffectSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UStatusEffectSubsystem::CatchUpIdleTimerWheel()
+{
+	// The wheel only advances while effects are active, so after an idle spell its tick is stale and delays
+	// counted from it would come due at once; with nothing pending, catching up fires nothing
+	if (TimerWheel.Num() == 0)
+	{
+		TArray<uint32> NoTimers;
+		TimerWheel.Advance(static_cast<uint64>(GetWorld()->GetTimeSeconds() / TimerResolution), NoTimers);
+	}
+}
+
+int32 UStatusEffectSubsystem::AllocateEffect()
+{
+	if (FirstFreeEffect == INDEX_NONE)
+	{
+		return Effects.AddDefaulted();
+	}
+
+	const int32 EffectIndex = FirstFreeEffect;
+	FirstFreeEffect = Effects[EffectIndex].NextOnTarget;
+	return EffectIndex;
+}
+
+void UStatusEffectSubsystem::EndEffect(int32 EffectIndex)
+{
+	FActiveStatusEffect& Effect = Effects[EffectIndex];
+	const FName EffectName = DefinitionNames[Effect.Definition];
+	UCombatComponent* Target = Effect.Target.Get();
+
+	TimerWheel.Cancel(Effect.ExpiryTimer);
+	TimerWheel.Cancel(Effect.PeriodTimer);
+	if (Target)
+	{
+		Target->AddDamageMitigationModifier(-Definitions[Effect.Definition].DamageMitigationPerStack * Effect.Stacks);
+	}
+
+	// Unlink from the target's list, dropping the list when it empties
+	if (Effect.PrevOnTarget != INDEX_NONE)
+	{
+		Effects[Effect.PrevOnTarget].NextOnTarget = Effect.NextOnTarget;
+	}
+	else if (Effect.NextOnTarget != INDEX_NONE)
+	{
+		FirstEffectByTarget[Effect.TargetKey] = Effect.NextOnTarget;
+	}
+	else
+	{
+		FirstEffectByTarget.Remove(Effect.TargetKey);
+	}
+	if (Effect.NextOnTarget != INDEX_NONE)
+	{
+		Effects[Effect.NextOnTarget].PrevOnTarget = Effect.PrevOnTarget;
+	}
+
+	Effect.Target.Reset();
+	Effect.TargetKey = nullptr;
+	Effect.Instigator.Reset();
+	Effect.Definition = INDEX_NONE;
+	Effect.Stacks = 0;
+	Effect.PrevOnTarget = INDEX_NONE;
+	++Effect.Generation;
+	--NumActiveEffects;
+
+	if (bHandlingTimers)
+	{
+		DeferredFreeEffects.Add(EffectIndex);
+	}
+	else
+	{
+		Effect.NextOnTarget = FirstFreeEffect;
+		FirstFreeEffect = EffectIndex;
+	}
+
+	if (Target)
+	{
+		OnStatusEffectChanged.Broadcast(Target, EffectName, 0);
+	}
+}
+
+void UStatusEffectSubsystem::RestartExpiry(FActiveStatusEffect& Effect, int32 EffectIndex)
+{
+	TimerWheel.Cancel(Effect.ExpiryTimer);
+
+	const float Duration = Definitions[Effect.Definition].Duration;
+	if (Duration > 0.0f)
+	{
+		Effect.ExpiryTimer = TimerWheel.Schedule(SecondsToTicks(Duration), MakePayload(EffectIndex, false));
+	}
+}
+
+void UStatusEffectSubsystem::ApplyPeriodicTick(int32 EffectIndex)
+{
+	FActiveStatusEffect& Effect = Effects[EffectIndex];
+	const FStatusEffectDefinition& Definition = Definitions[Effect.Definition];
+	UCombatComponent* Target = Effect.Target.Get();
+	if (!Target)
+	{
+		EndEffect(EffectIndex);
+		return;
+	}
+
+	// Rearm first, so a handler that ends the effect below also cancels the next tick
+	Effect.PeriodTimer = TimerWheel.Schedule(SecondsToTicks(Definition.TickInterval), MakePayload(EffectIndex, true));
+
+	const float Delta = Definition.ResourceDeltaPerTick * Effect.Stacks;
+	UResourceComponent* Resources = Target->GetResourceComponent();
+	if (Delta < 0.0f)
+	{
+		// Drains are coalesced per target with the frame's other hits and ticks into one resource change
+		Target->QueueDamage(-Delta, Effect.Instigator.Get(), Definition.ResourceType);
+	}
+	else if (Delta > 0.0f && Definition.ResourceType == EResourceType::Health)
+	{
+		Target->Heal(Delta, Effect.Instigator.Get());
+	}
+	else if (Delta > 0.0f && Resources)
+	{
+		Resources->RestoreResource(Definition.ResourceType, Delta);
+	}
+}
+
+void UStatusEffectSubsystem::SetStacks(int32 EffectIndex, int32 NewStacks)
+{
+	FActiveStatusEffect& Effect = Effects[EffectIndex];
+	UCombatComponent* Target = Effect.Target.Get();
+	if (Target)
+	{
+		Target->AddDamageMitigationModifier(Definitions[Effect.Definition].DamageMitigationPerStack * (NewStacks - Effect.Stacks));
+	}
+	Effect.Stacks = NewStacks;
+
+	if (Target)
+	{
+		OnStatusEffectChanged.Broadcast(Target, DefinitionNames[Effect.Definition], NewStacks);
+	}
+}
+
+FStatusEffectHandle UStatusEffectSubsystem::MakeHandle(int32 EffectIndex) const
+{
+	FStatusEffectHandle Handle;
+	Handle.Index = EffectIndex;
+	Handle.Generation = Effects[EffectIndex].Generation;
+	return Handle;
+}
+
+uint64 UStatusEffectSubsystem::SecondsToTicks(float Seconds)
+{
+	return static_cast<uint64>(FMath::Max<int64>(1, FMath::RoundToInt64(Seconds / TimerResolution)));
+}
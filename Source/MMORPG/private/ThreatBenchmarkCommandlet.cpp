@@ -0,0 +1,163 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ThreatBenchmarkCommandlet.h"
+#include "CombatCharacter.h"
+#include "CombatComponent.h"
+#include "ResourceComponent.h"
+#include "ThreatComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+namespace
+{
+	constexpr float TickRate = 30.0f;
+	constexpr float RingRadius = 120.0f;
+
+	// Every tenth attacker is a healer
+	constexpr int32 HealerSpacing = 10;
+
+	constexpr float AttackChancePerFrame = 0.5f;
+	constexpr float MinHitDamage = 5.0f;
+	constexpr float MaxHitDamage = 50.0f;
+	constexpr int32 CleaveTargetsPerFrame = 5;
+	constexpr float CleaveDamage = 20.0f;
+	constexpr float HealAmount = 30.0f;
+}
+
+void UThreatBenchmarkCommandlet::ParseParams(const FString& Params)
+{
+	FParse::Value(*Params, TEXT("attackers="), NumAttackers);
+	FParse::Value(*Params, TEXT("frames="), NumFrames);
+	NumAttackers = FMath::Max(1, NumAttackers);
+	NumFrames = FMath::Max(1, NumFrames);
+}
+
+void UThreatBenchmarkCommandlet::RunScenarios()
+{
+	const FScopedFixedTimeStep FixedTimeStep(TickRate, true);
+	UWorld* World = CreateBenchmarkWorld(TEXT("ThreatBenchmark"));
+	Boss = SpawnBoss(World);
+	BossCombat = Boss->FindComponentByClass<UCombatComponent>();
+	BossThreat = Boss->FindComponentByClass<UThreatComponent>();
+
+	Attackers.Reset(NumAttackers);
+	for (int32 Index = 0; Index < NumAttackers; ++Index)
+	{
+		const float Angle = 2.0f * PI * Index / NumAttackers;
+		const FVector Location(RingRadius * FMath::Cos(Angle), RingRadius * FMath::Sin(Angle), 100.0f);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ACombatCharacter* Character = World->SpawnActor<ACombatCharacter>(ACombatCharacter::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+		Character->GetCharacterMovement()->DisableMovement();
+
+		FBenchmarkAttacker& Attacker = Attackers.AddDefaulted_GetRef();
+		Attacker.Character = Character;
+		Attacker.Combat = Character->FindComponentByClass<UCombatComponent>();
+	}
+
+	// One operation is a server frame: hits, cleaves and heals feed the boss's table, then the damage queue flushes
+	const float DeltaTime = 1.0f / TickRate;
+	int32 Mismatches = 0;
+	RunScenario(FString::Printf(TEXT("Fight%d"), NumAttackers), NumFrames,
+		[this, &Mismatches](int32 Frame)
+		{
+			// Checked against the previous frame, outside the measurement
+			if (Frame > 0 && !IsTopThreatCorrect())
+			{
+				++Mismatches;
+			}
+
+			if (Frame % static_cast<int32>(TickRate) == 0)
+			{
+				UResourceComponent* BossResources = BossCombat->GetResourceComponent();
+				BossResources->RestoreResource(EResourceType::Health, BossResources->GetMaxResource(EResourceType::Health));
+			}
+		},
+		[this, World, DeltaTime](int32)
+		{
+			for (const FBenchmarkAttacker& Attacker : Attackers)
+			{
+				if (Random.GetFraction() < AttackChancePerFrame)
+				{
+					BossCombat->QueueDamage(Random.FRandRange(MinHitDamage, MaxHitDamage), Attacker.Character);
+				}
+			}
+
+			for (int32 Cleave = 0; Cleave < CleaveTargetsPerFrame; ++Cleave)
+			{
+				Attackers[Random.RandRange(0, Attackers.Num() - 1)].Combat->QueueDamage(CleaveDamage, Boss);
+			}
+
+			for (int32 HealerIndex = 0; HealerIndex < Attackers.Num(); HealerIndex += HealerSpacing)
+			{
+				Attackers[Random.RandRange(0, Attackers.Num() - 1)].Combat->Heal(HealAmount, Attackers[HealerIndex].Character);
+			}
+
+			World->Tick(LEVELTICK_All, DeltaTime);
+		});
+
+	if (!IsTopThreatCorrect())
+	{
+		++Mismatches;
+	}
+	if (Mismatches > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Cached top threat disagreed with a full scan on %d frames"), Mismatches);
+	}
+
+	const FBenchmarkResult& Result = GetLastResult();
+	AddResultMetric(TEXT("TopThreatMismatches"), Mismatches);
+	AddResultMetric(TEXT("TableEntries"), BossThreat->GetNumThreatTargets());
+	AddResultMetric(TEXT("FrameP50Ms"), Result.P50Nanoseconds / 1.0e6);
+	AddResultMetric(TEXT("FrameP99Ms"), Result.P99Nanoseconds / 1.0e6);
+
+	// What an NPC's AI pays to pick its target
+	AActor* TopTarget = nullptr;
+	RunScenario(TEXT("TopThreatQuery"), Iterations,
+		[this, &TopTarget](int32)
+		{
+			TopTarget = BossThreat->GetHighestThreatTarget();
+		});
+
+	// Threat from a single hit outside the damage queue, landing on a random attacker's entry
+	RunScenario(TEXT("AddThreat"), Iterations,
+		[this](int32)
+		{
+			BossThreat->AddThreat(Attackers[Random.RandRange(0, Attackers.Num() - 1)].Character, Random.FRandRange(MinHitDamage, MaxHitDamage));
+		});
+
+	Attackers.Reset();
+	Boss = nullptr;
+	BossCombat = nullptr;
+	BossThreat = nullptr;
+	DestroyBenchmarkWorld(World);
+}
+
+ACombatCharacter* UThreatBenchmarkCommandlet::SpawnBoss(UWorld* World)
+{
+	ACombatCharacter* Character = World->SpawnActorDeferred<ACombatCharacter>(ACombatCharacter::StaticClass(), FTransform::Identity,
+		nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	UThreatComponent* Threat = NewObject<UThreatComponent>(Character, TEXT("ThreatComponent"));
+	Character->AddInstanceComponent(Threat);
+	Threat->RegisterComponent();
+
+	Character->FinishSpawning(FTransform::Identity);
+	Character->GetCharacterMovement()->DisableMovement();
+	return Character;
+}
+
+bool UThreatBenchmarkCommandlet::IsTopThreatCorrect() const
+{
+	float HighestThreat = 0.0f;
+	for (const FBenchmarkAttacker& Attacker : Attackers)
+	{
+		HighestThreat = FMath::Max(HighestThreat, BossThreat->GetThreat(Attacker.Character));
+	}
+
+	// Ties may resolve to either attacker, so compare threat rather than actors
+	AActor* TopTarget = BossThreat->GetHighestThreatTarget();
+	const float TopThreat = TopTarget ? BossThreat->GetThreat(TopTarget) : 0.0f;
+	return FMath::IsNearlyEqual(TopThreat, HighestThreat, HighestThreat * 1.0e-4f);
+}
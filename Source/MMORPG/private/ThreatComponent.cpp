@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ThreatComponent.h"
+#include "CombatRegistry.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+UThreatComponent::UThreatComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UThreatComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Table.SetHalfLife(ThreatHalfLife);
+	CombatRegistry = GetWorld() ? GetWorld()->GetSubsystem<UCombatRegistry>() : nullptr;
+}
+
+void UThreatComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Table.Reset();
+	HandleTableChanged(false);
+	CombatRegistry = nullptr;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UThreatComponent::AddThreat(AActor* ThreatActor, float Amount)
+{
+	if (ThreatActor == GetOwner())
+	{
+		return;
+	}
+
+	HandleTableChanged(Table.AddThreat(ThreatActor, Amount, GetWorldTime()));
+}
+
+void UThreatComponent::AddDamageThreat(AActor* Attacker, float Damage)
+{
+	AddThreat(Attacker, Damage * DamageThreatMultiplier);
+}
+
+void UThreatComponent::AddHealThreat(AActor* Healer, float Healing)
+{
+	AddThreat(Healer, Healing * HealThreatMultiplier);
+}
+
+void UThreatComponent::RemoveThreatTarget(const AActor* ThreatActor)
+{
+	HandleTableChanged(Table.RemoveActor(ThreatActor));
+}
+
+void UThreatComponent::ClearThreat()
+{
+	const bool bHadThreat = Table.Num() > 0;
+	Table.Reset();
+	HandleTableChanged(bHadThreat);
+}
+
+AActor* UThreatComponent::GetHighestThreatTarget()
+{
+	return Table.GetTopActor();
+}
+
+float UThreatComponent::GetThreat(const AActor* ThreatActor) const
+{
+	return Table.GetThreat(ThreatActor, GetWorldTime());
+}
+
+void UThreatComponent::HandleTableChanged(bool bTopChanged)
+{
+	const bool bNowEngaged = Table.Num() > 0;
+	if (bNowEngaged != bEngaged && CombatRegistry)
+	{
+		CombatRegistry->SetThreatTableEngaged(this, bNowEngaged);
+	}
+	bEngaged = bNowEngaged;
+
+	if (bTopChanged)
+	{
+		OnTopThreatChanged.Broadcast(Table.GetTopActor());
+	}
+}
+
+double UThreatComponent::GetWorldTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
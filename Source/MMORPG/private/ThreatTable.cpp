@@ -0,0 +1,220 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ThreatTable.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+	// Rebasing keeps the stored scale factor below e^20, well inside float range
+	constexpr float MaxScaleExponent = 20.0f;
+
+	// Entries below this are dropped when threat is taken away or when the table rebases
+	constexpr float MinThreat = 0.01f;
+}
+
+void FThreatTable::SetHalfLife(float HalfLifeSeconds)
+{
+	DecayRate = HalfLifeSeconds > 0.0f ? UE_LN2 / HalfLifeSeconds : 0.0f;
+}
+
+bool FThreatTable::AddThreat(AActor* Actor, float Amount, double Now)
+{
+	if (!Actor || Amount == 0.0f)
+	{
+		return false;
+	}
+
+	const AActor* PreviousTop = Entries.IsValidIndex(TopIndex) ? Entries[TopIndex].Actor.Get() : nullptr;
+	const float ScaledAmount = ToScaled(Amount, Now);
+
+	int32 Index = FindIndex(Actor);
+	if (Index == INDEX_NONE)
+	{
+		if (Amount < 0.0f)
+		{
+			return false;
+		}
+
+		if (Entries.Num() == Capacity)
+		{
+			const int32 LowestIndex = FindLowestIndex();
+			if (Entries[LowestIndex].ScaledThreat >= ScaledAmount)
+			{
+				return false;
+			}
+			RemoveAt(LowestIndex);
+		}
+
+		Index = Entries.Add({ Actor, 0.0f });
+	}
+
+	FThreatEntry& Entry = Entries[Index];
+	Entry.ScaledThreat = FMath::Max(0.0f, Entry.ScaledThreat + ScaledAmount);
+
+	if (Amount > 0.0f)
+	{
+		// Increases can only promote this entry
+		if (!Entries.IsValidIndex(TopIndex) || Entry.ScaledThreat > Entries[TopIndex].ScaledThreat)
+		{
+			TopIndex = Index;
+		}
+	}
+	else
+	{
+		const bool bWasTop = Index == TopIndex;
+
+		// An entry taken down to nothing would stay a target and keep its owner engaged, so drop it
+		if (FromScaled(Entry.ScaledThreat, Now) < MinThreat)
+		{
+			RemoveAt(Index);
+		}
+
+		if (bWasTop)
+		{
+			RefreshTop();
+		}
+	}
+
+	const AActor* NewTop = Entries.IsValidIndex(TopIndex) ? Entries[TopIndex].Actor.Get() : nullptr;
+	return NewTop != PreviousTop;
+}
+
+bool FThreatTable::RemoveActor(const AActor* Actor)
+{
+	const int32 Index = FindIndex(Actor);
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const bool bWasTop = Index == TopIndex;
+	RemoveAt(Index);
+	if (bWasTop)
+	{
+		RefreshTop();
+	}
+	return bWasTop;
+}
+
+AActor* FThreatTable::GetTopActor()
+{
+	if (Entries.IsValidIndex(TopIndex) && !Entries[TopIndex].Actor.IsValid())
+	{
+		RefreshTop();
+	}
+	return Entries.IsValidIndex(TopIndex) ? Entries[TopIndex].Actor.Get() : nullptr;
+}
+
+float FThreatTable::GetThreat(const AActor* Actor, double Now) const
+{
+	const int32 Index = FindIndex(Actor);
+	return Index != INDEX_NONE ? FromScaled(Entries[Index].ScaledThreat, Now) : 0.0f;
+}
+
+void FThreatTable::Reset()
+{
+	Entries.Reset();
+	TopIndex = INDEX_NONE;
+}
+
+int32 FThreatTable::FindIndex(const AActor* Actor) const
+{
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (Entries[Index].Actor.Get() == Actor)
+		{
+			return Index;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FThreatTable::FindLowestIndex() const
+{
+	int32 LowestIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (LowestIndex == INDEX_NONE || Entries[Index].ScaledThreat < Entries[LowestIndex].ScaledThreat)
+		{
+			LowestIndex = Index;
+		}
+	}
+	return LowestIndex;
+}
+
+void FThreatTable::RemoveAt(int32 Index)
+{
+	// The last entry moves into the hole, so a cached top that was last follows it
+	const int32 LastIndex = Entries.Num() - 1;
+	Entries.RemoveAtSwap(Index, 1, false);
+	if (TopIndex == Index)
+	{
+		TopIndex = INDEX_NONE;
+	}
+	else if (TopIndex == LastIndex)
+	{
+		TopIndex = Index;
+	}
+}
+
+void FThreatTable::RefreshTop()
+{
+	TopIndex = INDEX_NONE;
+	for (int32 Index = Entries.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Entries[Index].Actor.IsValid())
+		{
+			Entries.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (TopIndex == INDEX_NONE || Entries[Index].ScaledThreat > Entries[TopIndex].ScaledThreat)
+		{
+			TopIndex = Index;
+		}
+	}
+}
+
+float FThreatTable::ToScaled(float Threat, double Now)
+{
+	if (DecayRate <= 0.0f)
+	{
+		return Threat;
+	}
+
+	if (Entries.Num() == 0)
+	{
+		BaseTime = Now;
+	}
+	else if (DecayRate * (Now - BaseTime) > MaxScaleExponent)
+	{
+		Rebase(Now);
+	}
+	return Threat * FMath::Exp(DecayRate * static_cast<float>(Now - BaseTime));
+}
+
+float FThreatTable::FromScaled(float ScaledThreat, double Now) const
+{
+	return DecayRate > 0.0f ? ScaledThreat * FMath::Exp(-DecayRate * static_cast<float>(Now - BaseTime)) : ScaledThreat;
+}
+
+void FThreatTable::Rebase(double Now)
+{
+	for (FThreatEntry& Entry : Entries)
+	{
+		Entry.ScaledThreat = FromScaled(Entry.ScaledThreat, Now);
+	}
+	BaseTime = Now;
+
+	// Long-forgotten attackers leave the table
+	for (int32 Index = Entries.Num() - 1; Index >= 0; --Index)
+	{
+		if (Entries[Index].ScaledThreat < MinThreat)
+		{
+			RemoveAt(Index);
+		}
+	}
+	RefreshTop();
+}
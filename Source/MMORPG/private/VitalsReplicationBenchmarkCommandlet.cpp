@@ -0,0 +1,344 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "VitalsReplicationBenchmarkCommandlet.h"
+#include "PlayerAttributesComponent.h"
+#include "Engine/World.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+namespace
+{
+	constexpr int32 NetUpdateRate = 30;
+
+	// Rep layout framing: a subobject reference and payload size, then handle-prefixed properties ending in a null handle
+	constexpr int32 SubobjectHeaderBits = 32;
+	constexpr int32 HandleBits = 8;
+	constexpr int32 ArrayNumBits = 16;
+	constexpr int32 FloatBits = 32;
+
+	// BaseMax, Modifier, Current and RegenRate, plus XP and Credits; what a pull-model pass compares per player
+	constexpr int32 FieldsPerAttribute = 4;
+	constexpr int32 ComparedFieldsPerPlayer = NumCombatResourceTypes * FieldsPerAttribute + 2;
+
+	// Max and RegenRate, and the fill levels as one value; what a push-model pass also compares for non-owners
+	constexpr int32 FieldsPerSimulated = 2;
+	constexpr int32 ComparedNonOwnerFieldsPerPlayer = NumCombatResourceTypes * FieldsPerSimulated + 1;
+
+	// A large fight: everyone attacks about once a second and is hit about as often
+	constexpr float HitsTakenPerSecond = 1.0f;
+	constexpr float MinHitFraction = 0.02f;
+	constexpr float MaxHitFraction = 0.08f;
+	constexpr float AttacksPerSecond = 1.0f;
+	constexpr float StaminaCost = 10.0f;
+	constexpr float ManaCost = 15.0f;
+	constexpr float HealsTakenPerSecond = 0.3f;
+	constexpr float HealFraction = 0.15f;
+	constexpr float XPPerKill = 100.0f;
+
+	// Regeneration buffs come and go every 20 seconds or so, and gear changes about once a minute; these are
+	// the changes that reach non-owners as new maximums and rates
+	constexpr float RegenBuffTogglesPerSecond = 0.05f;
+	constexpr float RegenBuffMultiplier = 2.0f;
+	constexpr float GearChangesPerSecond = 1.0f / 60.0f;
+
+	// Health is 500 to 750, as a modifier on top of the default maximum of 100
+	constexpr float MinHealthModifier = 400.0f;
+	constexpr float MaxHealthModifier = 650.0f;
+
+	// Every other player is a caster paying mana; the rest pay stamina
+	constexpr int32 CasterSpacing = 2;
+
+	constexpr float ManaRegenRate = 5.0f;
+	constexpr float StaminaRegenRate = 10.0f;
+
+	int32 CountChangedFields(const FResourceAttribute& Current, const FResourceAttribute& Sent)
+	{
+		return (Current.BaseMax != Sent.BaseMax) + (Current.Modifier != Sent.Modifier)
+			+ (Current.Current != Sent.Current) + (Current.RegenRate != Sent.RegenRate);
+	}
+
+	int32 CountChangedFields(const FSimulatedResource& Current, const FSimulatedResource& Sent)
+	{
+		return (Current.Max != Sent.Max) + (Current.RegenRate != Sent.RegenRate);
+	}
+
+	// Array handle and size, then each changed element's handle, its changed fields and a closing handle
+	template<typename ElementType>
+	int32 GetArrayUpdateBits(const TArray<ElementType>& Current, const TArray<ElementType>& Sent)
+	{
+		int32 Bits = 0;
+		for (int32 Index = 0; Index < Current.Num() && Index < Sent.Num(); ++Index)
+		{
+			const int32 ChangedFields = CountChangedFields(Current[Index], Sent[Index]);
+			if (ChangedFields > 0)
+			{
+				Bits += HandleBits + ChangedFields * (HandleBits + FloatBits) + HandleBits;
+			}
+		}
+		return Bits > 0 ? HandleBits + ArrayNumBits + Bits + HandleBits : 0;
+	}
+}
+
+void UVitalsReplicationBenchmarkCommandlet::ParseParams(const FString& Params)
+{
+	FParse::Value(*Params, TEXT("players="), NumPlayers);
+	FParse::Value(*Params, TEXT("seconds="), NumSeconds);
+	NumPlayers = FMath::Max(2, NumPlayers);
+	NumSeconds = FMath::Max(1, NumSeconds);
+}
+
+void UVitalsReplicationBenchmarkCommandlet::RunScenarios()
+{
+	const FScopedFixedTimeStep FixedTimeStep(NetUpdateRate, true);
+	UWorld* World = CreateBenchmarkWorld(TEXT("VitalsReplicationBenchmark"));
+	Players.Reset(NumPlayers);
+	for (int32 Index = 0; Index < NumPlayers; ++Index)
+	{
+		FBenchmarkPlayer& Player = Players.AddDefaulted_GetRef();
+		Player.Attributes = SpawnPlayer(World);
+
+		// Players join with their state already sent
+		MarkSent(Player);
+	}
+
+	int32 RoundTripErrors = 0;
+	const int32 QuantizedBits = MeasureQuantizedBits(RoundTripErrors);
+	if (RoundTripErrors > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%d quantized fill levels did not survive a serialization round trip"), RoundTripErrors);
+	}
+
+	const float DeltaTime = 1.0f / NetUpdateRate;
+	const float HitChance = HitsTakenPerSecond / NetUpdateRate;
+	const float AttackChance = AttacksPerSecond / NetUpdateRate;
+	const float HealChance = HealsTakenPerSecond / NetUpdateRate;
+	const float RegenBuffChance = RegenBuffTogglesPerSecond / NetUpdateRate;
+	const float GearChangeChance = GearChangesPerSecond / NetUpdateRate;
+
+	int64 PullBits = 0;
+	int64 OwnerBits = 0;
+	int64 NonOwnerBits = 0;
+	int64 PullComparisons = 0;
+	int64 PushComparisons = 0;
+	int64 OwnerUpdates = 0;
+	int64 NonOwnerUpdates = 0;
+	int64 SimulatedUpdates = 0;
+	int64 SuppressedNonOwnerUpdates = 0;
+	int32 Deaths = 0;
+	float MaxQuantizationError = 0.0f;
+
+	// One operation is a server frame followed by the net update that replicates it
+	RunScenario(FString::Printf(TEXT("Fight%d"), NumPlayers), NumSeconds * NetUpdateRate,
+		[&](int32)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+
+			for (int32 PlayerIndex = 0; PlayerIndex < Players.Num(); ++PlayerIndex)
+			{
+				FBenchmarkPlayer& Player = Players[PlayerIndex];
+				UPlayerAttributesComponent* Attributes = Player.Attributes;
+				const bool bCaster = PlayerIndex % CasterSpacing == 0;
+				const EResourceType CostType = bCaster ? EResourceType::Mana : EResourceType::Stamina;
+
+				if (Random.GetFraction() < HitChance)
+				{
+					Attributes->ModifyHP(-Attributes->GetMaxHP() * Random.FRandRange(MinHitFraction, MaxHitFraction));
+					Player.bDirty = true;
+				}
+				if (Random.GetFraction() < HealChance)
+				{
+					Attributes->ModifyHP(Attributes->GetMaxHP() * HealFraction);
+					Player.bDirty = true;
+				}
+				if (Random.GetFraction() < AttackChance)
+				{
+					Player.bDirty |= Attributes->ConsumeResource(CostType, bCaster ? ManaCost : StaminaCost);
+				}
+				if (Random.GetFraction() < RegenBuffChance)
+				{
+					Player.bBuffed = !Player.bBuffed;
+					const float BaseRate = bCaster ? ManaRegenRate : StaminaRegenRate;
+					Attributes->SetResourceRegenRate(CostType, Player.bBuffed ? BaseRate * RegenBuffMultiplier : BaseRate);
+					Player.bDirty = true;
+				}
+				if (Random.GetFraction() < GearChangeChance)
+				{
+					Attributes->ApplyMaxHPModifier(Random.FRandRange(MinHealthModifier, MaxHealthModifier));
+					Player.bDirty = true;
+				}
+				if (Attributes->GetHP() <= 0.0f)
+				{
+					Respawn(PlayerIndex);
+					++Deaths;
+				}
+			}
+
+			for (FBenchmarkPlayer& Player : Players)
+			{
+				// Pull model: every property of every player is compared each update, and changes go to everyone
+				PullComparisons += ComparedFieldsPerPlayer;
+				const int32 AttributeBits = GetAttributeUpdateBits(Player);
+				const int32 XPBits = Player.Attributes->GetXP() != Player.SentXP ? HandleBits + FloatBits : 0;
+				if (AttributeBits + XPBits > 0)
+				{
+					PullBits += static_cast<int64>(NumPlayers) * (SubobjectHeaderBits + AttributeBits + XPBits + HandleBits);
+				}
+
+				if (!Player.bDirty)
+				{
+					continue;
+				}
+
+				// Push model: only players marked dirty are compared; the owner gets full precision, everyone else
+				// gets fill levels when a 10-bit step changed, and maximums and rates when those changed
+				PushComparisons += ComparedFieldsPerPlayer + ComparedNonOwnerFieldsPerPlayer;
+				if (AttributeBits + XPBits > 0)
+				{
+					OwnerBits += SubobjectHeaderBits + AttributeBits + XPBits + HandleBits;
+					++OwnerUpdates;
+				}
+
+				const FQuantizedResourceFractions& Fractions = Player.Attributes->GetQuantizedFractions();
+				const bool bFractionsChanged = !(Fractions == Player.SentFractions);
+				const int32 SimulatedBits = GetSimulatedUpdateBits(Player);
+				if (bFractionsChanged || SimulatedBits > 0)
+				{
+					const int32 FractionBits = bFractionsChanged ? HandleBits + QuantizedBits : 0;
+					NonOwnerBits += static_cast<int64>(NumPlayers - 1) * (SubobjectHeaderBits + FractionBits + SimulatedBits + HandleBits);
+					++NonOwnerUpdates;
+					SimulatedUpdates += SimulatedBits > 0 ? 1 : 0;
+				}
+				else if (AttributeBits > 0)
+				{
+					++SuppressedNonOwnerUpdates;
+				}
+
+				// A change to the attributes this frame requantized every fill level, so they should match the values now
+				for (int32 ResourceIndex = 0; AttributeBits > 0 && ResourceIndex < NumCombatResourceTypes; ++ResourceIndex)
+				{
+					const EResourceType ResourceType = static_cast<EResourceType>(ResourceIndex);
+					const float MaxValue = Player.Attributes->GetMaxResource(ResourceType);
+					if (MaxValue > 0.0f)
+					{
+						const float Fraction = Player.Attributes->GetCurrentResource(ResourceType) / MaxValue;
+						MaxQuantizationError = FMath::Max(MaxQuantizationError, FMath::Abs(Fractions.GetFraction(ResourceIndex) - Fraction));
+					}
+				}
+				MarkSent(Player);
+			}
+		});
+
+	// Server outbound for the whole fight, and inbound for one client
+	const double Seconds = NumSeconds;
+	const double PushBits = static_cast<double>(OwnerBits + NonOwnerBits);
+	AddResultMetric(TEXT("PullServerKBps"), PullBits / 8.0 / 1000.0 / Seconds);
+	AddResultMetric(TEXT("PushServerKBps"), PushBits / 8.0 / 1000.0 / Seconds);
+	AddResultMetric(TEXT("PullClientKbps"), PullBits / NumPlayers / 1000.0 / Seconds);
+	AddResultMetric(TEXT("PushClientKbps"), PushBits / NumPlayers / 1000.0 / Seconds);
+	AddResultMetric(TEXT("OwnerShare"), PushBits > 0.0 ? OwnerBits / PushBits : 0.0);
+	AddResultMetric(TEXT("BandwidthSavedPct"), PullBits > 0 ? 100.0 * (1.0 - PushBits / PullBits) : 0.0);
+	AddResultMetric(TEXT("PullComparisonsPerUpdate"), static_cast<double>(PullComparisons) / (NumSeconds * NetUpdateRate));
+	AddResultMetric(TEXT("PushComparisonsPerUpdate"), static_cast<double>(PushComparisons) / (NumSeconds * NetUpdateRate));
+	AddResultMetric(TEXT("OwnerUpdatesPerSec"), OwnerUpdates / Seconds);
+	AddResultMetric(TEXT("NonOwnerUpdatesPerSec"), NonOwnerUpdates / Seconds);
+	AddResultMetric(TEXT("SimulatedResourcesUpdatesPerSec"), SimulatedUpdates / Seconds);
+	AddResultMetric(TEXT("SuppressedNonOwnerUpdatesPerSec"), SuppressedNonOwnerUpdates / Seconds);
+	AddResultMetric(TEXT("QuantizedBits"), QuantizedBits);
+	AddResultMetric(TEXT("MaxQuantizationErrorPct"), 100.0 * MaxQuantizationError);
+	AddResultMetric(TEXT("RoundTripErrors"), RoundTripErrors);
+	AddResultMetric(TEXT("DeathsPerSec"), Deaths / Seconds);
+
+	// What the server pays for one hit on a player, including requantizing the non-owner view
+	RunScenario(TEXT("Change"), Iterations,
+		[this](int32 Operation)
+		{
+			Players[Operation % Players.Num()].Attributes->ModifyHP(Operation & 1 ? 1.0f : -1.0f);
+		});
+
+	Players.Reset();
+	DestroyBenchmarkWorld(World);
+}
+
+UPlayerAttributesComponent* UVitalsReplicationBenchmarkCommandlet::SpawnPlayer(UWorld* World)
+{
+	AActor* Actor = World->SpawnActorDeferred<AActor>(AActor::StaticClass(), FTransform::Identity,
+		nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	UPlayerAttributesComponent* Attributes = NewObject<UPlayerAttributesComponent>(Actor, TEXT("PlayerAttributes"));
+	Actor->AddInstanceComponent(Attributes);
+	Attributes->RegisterComponent();
+
+	// BeginPlay fills every resource to the maximums set here
+	Attributes->ApplyMaxHPModifier(Random.FRandRange(MinHealthModifier, MaxHealthModifier));
+	Attributes->SetResourceRegenRate(EResourceType::Mana, ManaRegenRate);
+	Attributes->SetResourceRegenRate(EResourceType::Stamina, StaminaRegenRate);
+
+	Actor->FinishSpawning(FTransform::Identity);
+	return Attributes;
+}
+
+void UVitalsReplicationBenchmarkCommandlet::Respawn(int32 PlayerIndex)
+{
+	FBenchmarkPlayer& Player = Players[PlayerIndex];
+	FResourceAmounts Refill;
+	for (int32 ResourceIndex = 0; ResourceIndex < NumCombatResourceTypes; ++ResourceIndex)
+	{
+		const EResourceType ResourceType = static_cast<EResourceType>(ResourceIndex);
+		Refill.Set(ResourceType, Player.Attributes->GetMaxResource(ResourceType));
+	}
+	Player.Attributes->ApplyResourceDeltas(Refill, false);
+	Player.bDirty = true;
+
+	int32 KillerIndex = Random.RandRange(0, Players.Num() - 2);
+	KillerIndex += KillerIndex >= PlayerIndex ? 1 : 0;
+	Players[KillerIndex].Attributes->AddXP(XPPerKill);
+	Players[KillerIndex].bDirty = true;
+}
+
+void UVitalsReplicationBenchmarkCommandlet::MarkSent(FBenchmarkPlayer& Player)
+{
+	Player.SentAttributes = Player.Attributes->GetAttributes();
+	Player.SentXP = Player.Attributes->GetXP();
+	Player.SentFractions = Player.Attributes->GetQuantizedFractions();
+	Player.SentSimulated = Player.Attributes->GetSimulatedResources();
+	Player.bDirty = false;
+}
+
+int32 UVitalsReplicationBenchmarkCommandlet::GetAttributeUpdateBits(const FBenchmarkPlayer& Player)
+{
+	return GetArrayUpdateBits(Player.Attributes->GetAttributes(), Player.SentAttributes);
+}
+
+int32 UVitalsReplicationBenchmarkCommandlet::GetSimulatedUpdateBits(const FBenchmarkPlayer& Player)
+{
+	return GetArrayUpdateBits(Player.Attributes->GetSimulatedResources(), Player.SentSimulated);
+}
+
+int32 UVitalsReplicationBenchmarkCommandlet::MeasureQuantizedBits(int32& OutRoundTripErrors)
+{
+	// Every step of every resource must come back unchanged
+	OutRoundTripErrors = 0;
+	int32 Bits = 0;
+	for (uint32 Step = 0; Step <= FQuantizedResourceFractions::MaxSteps; ++Step)
+	{
+		FQuantizedResourceFractions Original;
+		for (int32 ResourceIndex = 0; ResourceIndex < NumCombatResourceTypes; ++ResourceIndex)
+		{
+			Original.SetFraction(ResourceIndex, static_cast<float>((Step + ResourceIndex * 337) % (FQuantizedResourceFractions::MaxSteps + 1)) / FQuantizedResourceFractions::MaxSteps);
+		}
+
+		bool bSuccess = false;
+		FBitWriter Writer(64, true);
+		Original.NetSerialize(Writer, nullptr, bSuccess);
+		Bits = static_cast<int32>(Writer.GetNumBits());
+
+		FQuantizedResourceFractions Received;
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		Received.NetSerialize(Reader, nullptr, bSuccess);
+		if (!bSuccess || Reader.IsError() || !(Received == Original))
+		{
+			++OutRoundTripErrors;
+		}
+	}
+	return Bits;
+}
@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/DataTable.h"
+#include "CombatTypes.h"
+#include "AbilityRegistry.generated.h"
+
+/**
+ * Data table row describing an ability definition; the row name is the ability's name
+ */
+USTRUCT(BlueprintType)
+struct FAbilityDefinitionRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability")
+	FAttackAbilityData Ability;
+};
+
+/**
+ * Ability Registry Subsystem
+ * Owns one immutable definition per ability, loaded once from data and addressed by FAbilityHandle
+ * Combat components store handles instead of their own copies of the ability data
+ * Handles are registration order indices, so every process that loads the same data agrees on them
+ */
+UCLASS(Config = Game)
+class MMORPG_API UAbilityRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Names of the abilities every combat component uses unless told otherwise */
+	static const FName DefaultMeleeAbility;
+	static const FName DefaultRangedAbility;
+	static const FName DefaultMagicalAbility;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Register every row of an ability definition table whose name is not already registered */
+	UFUNCTION(BlueprintCallable, Category = "Ability Registry")
+	void LoadDefinitions(UDataTable* DefinitionTable);
+
+	/** Register an ability under a new name; a name that is already registered keeps its definition and returns its handle */
+	UFUNCTION(BlueprintCallable, Category = "Ability Registry")
+	FAbilityHandle RegisterAbility(FName AbilityName, const FAttackAbilityData& Ability);
+
+	/** Find the handle of a named ability; the handle is invalid if no such ability is registered */
+	UFUNCTION(BlueprintCallable, Category = "Ability Registry")
+	FAbilityHandle FindAbility(FName AbilityName) const;
+
+	/** Get the definition behind a handle, or nullptr if the handle is invalid */
+	const FAttackAbilityData* GetAbility(FAbilityHandle Handle) const;
+
+	/** Get the number of registered definitions */
+	UFUNCTION(BlueprintCallable, Category = "Ability Registry")
+	int32 GetNumDefinitions() const { return Definitions.Num(); }
+
+	/** Get the registry from the running engine */
+	static UAbilityRegistry* Get();
+
+protected:
+	/** Definition table loaded when the subsystem starts; its rows override the built-in defaults */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> AbilityDefinitionTable;
+
+	/** Shared definitions, indexed by handle */
+	UPROPERTY()
+	TArray<FAttackAbilityData> Definitions;
+
+	/** Handle index by ability name */
+	TMap<FName, uint16> DefinitionIndexByName;
+
+	/** Register the melee, ranged and magical attacks combat components fall back to, unless the table defined them */
+	void RegisterDefaultAbilities();
+};
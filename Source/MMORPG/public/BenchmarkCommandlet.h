@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BenchmarkCommandlet.generated.h"
+
+class UWorld;
+
+/**
+ * Measurements for one benchmark scenario
+ */
+struct FBenchmarkResult
+{
+	FString Scenario;
+	int32 Operations = 0;
+	double TotalSeconds = 0.0;
+
+	/** Allocations and reallocations made inside the measured operations */
+	int64 Allocations = 0;
+	int64 BytesAllocated = 0;
+
+	/** Highest live heap growth above the scenario's starting point */
+	int64 PeakLiveBytes = 0;
+
+	/** Single-operation time percentiles; only set for scenarios timed one operation at a time */
+	double P50Nanoseconds = 0.0;
+	double P95Nanoseconds = 0.0;
+	double P99Nanoseconds = 0.0;
+
+	/** Scenario-specific measurements, such as throughput in the scenario's own units */
+	TArray<TPair<FString, double>> Metrics;
+
+	double GetNanosecondsPerOperation() const { return Operations > 0 ? TotalSeconds * 1.0e9 / Operations : 0.0; }
+};
+
+/**
+ * Base for headless benchmark commandlets
+ * Times scenarios, counts heap allocations made inside them and writes the results as CSV
+ * Run with: UnrealEditor-Cmd <Project>.uproject -run=<Name> -nullrhi [-iterations=N] [-seed=N] [-csv=Path]
+ */
+UCLASS(Abstract)
+class MMORPG_API UBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	/** Read commandlet-specific switches; -iterations, -seed and -csv are already handled */
+	virtual void ParseParams(const FString& Params) {}
+
+	/** Run every scenario through RunScenario */
+	virtual void RunScenarios() PURE_VIRTUAL(UBenchmarkCommandlet::RunScenarios, );
+
+	/** File name of the CSV written under Saved/Benchmarks when -csv is not given */
+	virtual FString GetDefaultCsvName() const PURE_VIRTUAL(UBenchmarkCommandlet::GetDefaultCsvName, return FString(););
+
+	/**
+	 * Time a loop of operations as a whole
+	 * @param Name Scenario name written to the CSV
+	 * @param Operations Number of times to call Operation
+	 * @param Operation Called with the operation index
+	 */
+	void RunScenario(const FString& Name, int32 Operations, TFunctionRef<void(int32)> Operation);
+
+	/**
+	 * Time operations one at a time, leaving the setup before each one out of the measurement
+	 * @param Name Scenario name written to the CSV
+	 * @param Operations Number of times to call Setup and then Operation
+	 * @param Setup Prepares state for the next operation; neither timed nor counted
+	 * @param Operation Called with the operation index
+	 */
+	void RunScenario(const FString& Name, int32 Operations, TFunctionRef<void(int32)> Setup, TFunctionRef<void(int32)> Operation);
+
+	/** Get the measurements of the scenario that ran last */
+	const FBenchmarkResult& GetLastResult() const { return Results.Last(); }
+
+	/** Attach a named measurement to the scenario that ran last */
+	void AddResultMetric(const FString& Name, double Value);
+
+	/** Create a game world with play begun, so spawned actors and world subsystems behave as in a match */
+	UWorld* CreateBenchmarkWorld(const TCHAR* Name);
+
+	/** Tear down a world made by CreateBenchmarkWorld and collect its garbage */
+	void DestroyBenchmarkWorld(UWorld* World);
+
+	/**
+	 * Runs the engine at a fixed timestep, optionally with LogTemp limited to errors, until it goes out of scope
+	 * The fixed step keeps timers, cooldowns and the random stream in lockstep between runs; combat code logs
+	 * every hit and resource change, which at benchmark scale would be measured instead
+	 */
+	class FScopedFixedTimeStep
+	{
+	public:
+		FScopedFixedTimeStep(double TickRate, bool bInQuietLog);
+		~FScopedFixedTimeStep();
+
+		UE_NONCOPYABLE(FScopedFixedTimeStep);
+
+	private:
+		bool bWasUsingFixedTimeStep;
+		double PreviousFixedDeltaTime;
+		ELogVerbosity::Type PreviousLogVerbosity;
+		bool bQuietLog;
+	};
+
+	/** Operations per scenario, from -iterations */
+	int32 Iterations = 10000;
+
+	/** Seeded from -seed so runs are repeatable */
+	FRandomStream Random;
+
+private:
+	bool WriteCsv(const FString& Path) const;
+
+	TArray<FBenchmarkResult> Results;
+};
@@ -0,0 +1,35 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BenchmarkCommandlet.h"
+#include "CombatSpatialGrid.h"
+#include "CombatAreaBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless area-of-effect benchmark
+ * Scatters 5,000 combatant positions over a battlefield and measures grid rebuilds, circle, cone and
+ * line queries against a brute-force scan, and whole simulated seconds of 500 casts at 30 Hz
+ * Run with: UnrealEditor-Cmd MMORPG.uproject -run=CombatAreaBenchmark -nullrhi [-iterations=N] [-seed=N] [-csv=Path]
+ */
+UCLASS()
+class MMORPG_API UCombatAreaBenchmarkCommandlet : public UBenchmarkCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void RunScenarios() override;
+	virtual FString GetDefaultCsvName() const override { return TEXT("CombatAreaBenchmark.csv"); }
+
+private:
+	/** Move every combatant a short random step, as between two server frames */
+	void MoveCombatants();
+
+	/** Pick a random caster and build a random area of the given shape around it */
+	FCombatAreaQuery MakeRandomArea(EAreaShape Shape);
+
+	TArray<FVector> Positions;
+	FCombatSpatialGrid Grid;
+	TArray<int32> Hits;
+};
@@ -63,7 +63,11 @@ private:
 	UFUNCTION()
 	void OnAttackExecuted(EAttackType AttackType, AActor* Target, float Damage);
 
-	// Callback for resource changes (for UI updates)
+	// Callback for resource changes (for UI updates); one call per batch of changes
 	UFUNCTION()
-	void OnResourceChanged(EResourceType ResourceType, float CurrentValue, float MaxValue);
+	void OnResourcesChanged(int32 ChangedResourceMask);
+
+	// Callback for NPCs with a threat component: attack whoever has the most threat
+	UFUNCTION()
+	void OnTopThreatChanged(AActor* NewTopThreat);
 };
@@ -5,15 +5,22 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "CombatTypes.h"
+#include "Engine/NetSerialization.h"
 #include "CombatComponent.generated.h"
 
 class UResourceComponent;
+class UCombatRegistry;
+class UCombatDamageQueue;
+class UCombatProjectileSubsystem;
+class UThreatComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnAttackExecuted, EAttackType, AttackType, AActor*, Target, float, Damage);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDamageTaken, AActor*, Instigator, float, Damage);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAbilityCooldownExpired, EAttackType, AttackType);
 
 /**
  * Component that handles combat abilities and attacks
+ * Does not tick: cooldowns are stored as world-time expiries and expiry events come from the world timer manager
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class MMORPG_API UCombatComponent : public UActorComponent
@@ -24,11 +31,17 @@ public:
 	UCombatComponent();
 
 	virtual void BeginPlay() override;
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	// Execute an attack ability
+	// Execute a registered ability; area abilities hit every combatant in their shape, and Target only aims them
 	UFUNCTION(BlueprintCallable, Category = "Combat")
-	bool ExecuteAttack(const FAttackAbilityData& AbilityData, AActor* Target);
+	bool ExecuteAttack(FAbilityHandle Ability, AActor* Target);
+
+	// Execute an ability with the target's range checked where it was at a past server world time,
+	// such as the time the client fired; the rewind is limited by the combat registry
+	// Clients must send the time from AGameStateBase::GetServerWorldTimeSeconds, not their own world time
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	bool ExecuteAttackAtTime(FAbilityHandle Ability, AActor* Target, double ServerWorldTime);
 
 	// Execute a melee attack
 	UFUNCTION(BlueprintCallable, Category = "Combat")
@@ -42,10 +55,35 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Combat")
 	bool ExecuteMagicalAttack(AActor* Target);
 
-	// Apply damage to this actor
+	// Apply damage to this actor immediately, after mitigation
 	UFUNCTION(BlueprintCallable, Category = "Combat")
 	void TakeDamage(float Damage, AActor* DamageInstigator);
 
+	// Queue damage for this actor; it is mitigated and applied with the rest of this frame's hits
+	// Draining another resource, such as an AoE mana burn tick, batches the same way without mitigation
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void QueueDamage(float Damage, AActor* DamageInstigator, EResourceType ResourceType = EResourceType::Health);
+
+	// Restore health; when Healer is set the heal adds threat on every NPC fighting this actor
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void Heal(float Amount, AActor* Healer);
+
+	// Get the damage left after this actor's mitigation
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	float MitigateDamage(float Damage) const;
+
+	// Drain already mitigated amounts from every resource in one batch, firing OnDamageTaken once if health dropped
+	void ApplyResolvedDamage(const FResourceAmounts& Drains, AActor* DamageInstigator);
+
+	// Add to the fraction of damage blocked on top of DamageMitigation; status effects use this for buffs and debuffs
+	void AddDamageMitigationModifier(float Delta) { DamageMitigationModifier += Delta; }
+
+	// Get the resource component found in BeginPlay
+	UResourceComponent* GetResourceComponent() const { return ResourceComponent; }
+
+	// Get the threat component found in BeginPlay; null for combatants that keep no threat
+	UThreatComponent* GetThreatComponent() const { return ThreatComponent; }
+
 	// Check if an ability is on cooldown
 	UFUNCTION(BlueprintCallable, Category = "Combat")
 	bool IsAbilityOnCooldown(EAttackType AttackType) const;
@@ -62,6 +100,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Combat")
 	FWeaponData GetEquippedWeapon() const { return EquippedWeapon; }
 
+	// Get the ability used for an attack type
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	FAbilityHandle GetAbilityForAttackType(EAttackType AttackType) const;
+
+	// Use a registered ability for an attack type
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void SetAbilityForAttackType(EAttackType AttackType, FAbilityHandle Ability);
+
 	// Events
 	UPROPERTY(BlueprintAssignable, Category = "Combat")
 	FOnAttackExecuted OnAttackExecuted;
@@ -69,32 +115,81 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Combat")
 	FOnDamageTaken OnDamageTaken;
 
+	// Fired when an ability's cooldown ends
+	UPROPERTY(BlueprintAssignable, Category = "Combat")
+	FOnAbilityCooldownExpired OnAbilityCooldownExpired;
+
 protected:
 	// Reference to resource component
 	UPROPERTY()
 	UResourceComponent* ResourceComponent;
 
+	// Threat table damage taken is credited to, if the owner has one
+	UPROPERTY()
+	UThreatComponent* ThreatComponent = nullptr;
+
+	// Registry this component joined in BeginPlay; null outside game worlds
+	UPROPERTY()
+	UCombatRegistry* CombatRegistry = nullptr;
+
+	// Damage queue hits are routed through; null outside game worlds
+	UPROPERTY()
+	UCombatDamageQueue* DamageQueue = nullptr;
+
+	// Flies projectile attacks; null outside game worlds, where they hit instantly
+	UPROPERTY()
+	UCombatProjectileSubsystem* ProjectileSubsystem = nullptr;
+
+	// Fraction of incoming damage blocked
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float DamageMitigation = 0.0f;
+
+	// Sum of active mitigation modifiers
+	float DamageMitigationModifier = 0.0f;
+
 	// Currently equipped weapon
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
 	FWeaponData EquippedWeapon;
 
-	// Attack abilities
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
-	FAttackAbilityData MeleeAbility;
+	// Attack abilities, by their name in the ability registry; resolved to handles in BeginPlay
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat")
+	FName MeleeAbilityName;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
-	FAttackAbilityData RangedAbility;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat")
+	FName RangedAbilityName;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
-	FAttackAbilityData MagicalAbility;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat")
+	FName MagicalAbilityName;
+
+	UPROPERTY()
+	FAbilityHandle MeleeAbility;
+
+	UPROPERTY()
+	FAbilityHandle RangedAbility;
 
-	// Cooldown tracking
 	UPROPERTY()
-	TMap<EAttackType, float> AbilityCooldowns;
+	FAbilityHandle MagicalAbility;
+
+	// World time at which each ability's cooldown ends; remaining time is computed on query
+	UPROPERTY()
+	TMap<EAttackType, double> CooldownExpiryTimes;
+
+	// Pending expiry notifications in the world timer manager
+	TMap<EAttackType, FTimerHandle> CooldownTimerHandles;
+
+	// Fly a copy of a projectile the server launched on every client, so remote players see the shot
+	// The copy only draws; hits and damage are resolved on the server
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastProjectileLaunched(AActor* Target, FVector_NetQuantize Start, FVector_NetQuantize Velocity, float MaxDistance);
 
 	// Helper functions
-	bool CanExecuteAttack(const FAttackAbilityData& AbilityData, AActor* Target);
+	bool ExecuteAbility(const FAttackAbilityData& AbilityData, AActor* Target, double TargetTime);
+	float GetAbilityRange(const FAttackAbilityData& AbilityData) const;
+	bool CanExecuteAttack(const FAttackAbilityData& AbilityData, float Range, AActor* Target, double TargetTime);
 	void ApplyCooldown(EAttackType AttackType, float Cooldown);
-	void UpdateCooldowns(float DeltaTime);
-	bool IsTargetInRange(AActor* Target, float Range) const;
+	void HandleCooldownExpired(EAttackType AttackType);
+	double GetWorldTime() const;
+	bool IsTargetInRange(AActor* Target, float Range, double TargetTime) const;
+	FVector GetTargetLocationAt(AActor* Target, double TargetTime) const;
+	void QueueAreaDamage(const FAttackAbilityData& AbilityData, float Range, AActor* Target, float Damage);
 };
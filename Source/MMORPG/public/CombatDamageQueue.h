@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatTypes.h"
+#include "CombatDamageQueue.generated.h"
+
+class UCombatComponent;
+
+/**
+ * One hit waiting to be applied
+ */
+struct FQueuedDamage
+{
+	TWeakObjectPtr<UCombatComponent> Victim;
+	TWeakObjectPtr<AActor> Instigator;
+	float Damage = 0.0f;
+
+	/** Resource the hit drains; only health damage is mitigated and draws threat */
+	EResourceType ResourceType = EResourceType::Health;
+};
+
+/**
+ * Combat Damage Queue Subsystem
+ * Collects hits during the frame and applies them in one pass at the end of it
+ * Each victim has all of its hits mitigated and summed per resource, then takes a single batched
+ * resource change and fires OnDamageTaken once, however many attacks and AoE ticks landed on it that frame
+ */
+UCLASS()
+class MMORPG_API UCombatDamageQueue : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Queue a hit to be applied when the queue is next flushed */
+	void QueueDamage(UCombatComponent* Victim, float Damage, AActor* DamageInstigator, EResourceType ResourceType = EResourceType::Health);
+
+	/** Apply every queued hit now; damage queued while applying, and calls made from its handlers, wait for the next flush */
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void FlushDamage();
+
+	/** Get the number of hits waiting to be applied */
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	int32 GetNumQueuedDamage() const { return PendingDamage.Num(); }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return PendingDamage.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Per-victim total for one flush */
+	struct FVictimDamage
+	{
+		UCombatComponent* Victim = nullptr;
+		AActor* LastInstigator = nullptr;
+		FResourceAmounts Drains;
+	};
+
+	/** Hits queued this frame */
+	TArray<FQueuedDamage> PendingDamage;
+
+	/** Scratch buffers reused by every flush to avoid per-frame allocations */
+	TArray<FQueuedDamage> ResolvingDamage;
+	TArray<FVictimDamage> VictimTotals;
+	TMap<UCombatComponent*, int32> VictimTotalIndices;
+
+	/** Set while a flush runs its handlers */
+	bool bFlushing = false;
+};
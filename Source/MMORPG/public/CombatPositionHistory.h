@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed-size ring buffer of an actor's recent positions, used to rewind it for lag compensation
+ * Sample times and positions are kept in separate inline arrays, so a rewind scans only the times
+ * Recording never allocates and a history's memory is the same however long the actor lives
+ * Samples are kept at least SampleInterval apart, so the history spans the same time at any server tick rate;
+ * the newest sample is always the latest recorded position
+ */
+struct MMORPG_API FCombatPositionHistory
+{
+	static constexpr int32 Capacity = 32;
+
+	/** Shortest gap between stored samples; Capacity of them cover just over one second */
+	static constexpr double SampleInterval = 1.0 / 30.0;
+
+	/** Seconds of history a full buffer is guaranteed to cover */
+	static constexpr double MinHistorySeconds = (Capacity - 1) * SampleInterval;
+
+	/**
+	 * Add a sample, overwriting the oldest once the buffer is full; times must not go backwards
+	 * A sample less than SampleInterval after the one before the newest replaces the newest instead
+	 */
+	void Record(double Time, const FVector& Position);
+
+	/**
+	 * Get the position at a past time, interpolated between the samples either side of it
+	 * Times before the oldest sample clamp to it and times after the newest clamp to the newest
+	 * @return False if nothing has been recorded yet
+	 */
+	bool GetPositionAt(double Time, FVector& OutPosition) const;
+
+	/** Forget every sample */
+	void Reset() { NumSamples = 0; Head = 0; }
+
+	int32 Num() const { return NumSamples; }
+
+private:
+	/** Ring index of the Age-th newest sample */
+	int32 GetIndex(int32 Age) const { return (Head - 1 - Age + Capacity) % Capacity; }
+
+	double Times[Capacity];
+	FVector3f Positions[Capacity];
+
+	/** Ring index the next sample is written to */
+	int32 Head = 0;
+	int32 NumSamples = 0;
+};
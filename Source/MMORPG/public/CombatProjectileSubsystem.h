@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatProjectileSubsystem.generated.h"
+
+class UCombatRegistry;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Combat Projectile Subsystem
+ * Flies every ranged and magical projectile in the world without spawning an actor per shot
+ * Projectiles are rows in parallel arrays that are moved in one pass per tick, hit-tested against the
+ * combatant they were fired at and drawn as instances of a single instanced static mesh
+ * Finished projectiles are swapped out of the arrays, which keep their capacity for the next shots
+ * Damage is resolved only on the server; UCombatComponent multicasts each launch so clients fly and
+ * draw a copy that stops at the target without dealing damage
+ */
+UCLASS(Config = Game)
+class MMORPG_API UCombatProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/**
+	 * Launch a projectile in a straight line
+	 * @param ProjectileInstigator Receives credit for the damage
+	 * @param Target The only combatant the projectile can hit; it passes through everyone else
+	 * @param Start Where the projectile starts
+	 * @param Velocity Direction times speed, in units per second
+	 * @param Damage Queued on the target if the projectile reaches it
+	 * @param MaxDistance Distance flown before the projectile disappears
+	 */
+	void LaunchProjectile(AActor* ProjectileInstigator, AActor* Target, const FVector& Start, const FVector& Velocity, float Damage, float MaxDistance);
+
+	/** Get the number of projectiles in flight */
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	int32 GetNumProjectiles() const { return Positions.Num(); }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Positions.Num() > 0 || bHasRenderedInstances; }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Mesh drawn for every projectile; projectiles are not drawn without one */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UStaticMesh> ProjectileMesh;
+
+	/** Distance from the target's location, on the ground plane, within which a projectile hits it */
+	UPROPERTY(Config)
+	float HitRadius = 60.0f;
+
+private:
+	/** Move projectiles, resolve hits on their targets and retire finished projectiles */
+	void SimulateProjectiles(float DeltaTime);
+
+	/** Match the instanced mesh to the projectiles in flight */
+	void UpdateInstances();
+
+	void RemoveProjectile(int32 Index);
+
+	/** Projectiles in flight, one row per index across every array */
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> RemainingTimes;
+	TArray<float> Damages;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+	TArray<TWeakObjectPtr<AActor>> Targets;
+
+	UPROPERTY()
+	UCombatRegistry* CombatRegistry = nullptr;
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* InstancedMesh = nullptr;
+
+	bool bHasRenderedInstances = false;
+	bool bTriedCreatingInstancedMesh = false;
+
+	/** Scratch reused by every tick */
+	TArray<int32> FinishedProjectiles;
+	TArray<FTransform> InstanceTransforms;
+};
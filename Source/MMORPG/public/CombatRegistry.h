@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatSpatialGrid.h"
+#include "CombatPositionHistory.h"
+#include "CombatRegistry.generated.h"
+
+class UCombatComponent;
+class UResourceComponent;
+class UThreatComponent;
+
+/**
+ * An actor taking part in combat and its cached combat components
+ */
+USTRUCT(BlueprintType)
+struct FCombatantEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Combat")
+	AActor* Actor = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Combat")
+	UCombatComponent* Combat = nullptr;
+
+	/** May be null for combatants without resources */
+	UPROPERTY(BlueprintReadOnly, Category = "Combat")
+	UResourceComponent* Resources = nullptr;
+
+	/** Only set for combatants that keep a threat table, usually NPCs */
+	UPROPERTY(BlueprintReadOnly, Category = "Combat")
+	UThreatComponent* Threat = nullptr;
+};
+
+/**
+ * Combat Registry Subsystem
+ * Maps every actor with a UCombatComponent to its combat and resource components
+ * Combat components register in BeginPlay and unregister in EndPlay, so lookups on the
+ * attack path are a single hash instead of a walk over the target's components
+ * Area queries go through a spatial grid of combatant positions rebuilt at most once per frame
+ * On the server it also records every combatant's position each tick, so range checks can be
+ * rewound to the time a client saw the attack
+ * Threat tables holding any threat are tracked here, so heals and deaths only visit tables in combat
+ */
+UCLASS()
+class MMORPG_API UCombatRegistry : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Add a combat component's owner; its resource component is looked up once here */
+	void RegisterCombatant(UCombatComponent* Combat);
+
+	/** Remove a combat component's owner */
+	void UnregisterCombatant(UCombatComponent* Combat);
+
+	/** Find an actor's entry, or nullptr if it isn't a registered combatant */
+	const FCombatantEntry* FindCombatant(const AActor* Actor) const;
+
+	/** Get an actor's combat component, or nullptr if it isn't a registered combatant */
+	UFUNCTION(BlueprintCallable, Category = "Combat Registry")
+	UCombatComponent* FindCombatComponent(const AActor* Actor) const;
+
+	/** Get an actor's resource component, or nullptr if it has none or isn't registered */
+	UFUNCTION(BlueprintCallable, Category = "Combat Registry")
+	UResourceComponent* FindResourceComponent(const AActor* Actor) const;
+
+	/** Get an actor's threat component, or nullptr if it has none or isn't registered */
+	UFUNCTION(BlueprintCallable, Category = "Combat Registry")
+	UThreatComponent* FindThreatComponent(const AActor* Actor) const;
+
+	/** Get every registered combatant, densely packed for iteration */
+	UFUNCTION(BlueprintCallable, Category = "Combat Registry")
+	const TArray<FCombatantEntry>& GetCombatants() const { return Combatants; }
+
+	/** Get the number of registered combatants */
+	UFUNCTION(BlueprintCallable, Category = "Combat Registry")
+	int32 GetNumCombatants() const { return Combatants.Num(); }
+
+	/**
+	 * Find every combatant whose actor location lies inside an area
+	 * Positions are those at the grid's last rebuild, which happens on the first query of each frame
+	 * @param Area The area to search
+	 * @return Indices into GetCombatants(), valid until the next query or registry change
+	 */
+	TConstArrayView<int32> FindCombatantsInArea(const FCombatAreaQuery& Area);
+
+	/**
+	 * Get where a combatant was at a past world time, from its recorded position history
+	 * Rewinds are limited to MaxRewindSeconds; older times clamp to that limit
+	 * @return False if the actor isn't a registered combatant or has no history yet
+	 */
+	bool GetCombatantLocationAt(const AActor* Actor, double WorldTime, FVector& OutLocation) const;
+
+	/** Track a threat table as it gains its first entry or loses its last; called by UThreatComponent */
+	void SetThreatTableEngaged(UThreatComponent* Threat, bool bEngaged);
+
+	/** Credit a heal as threat to the healer on every engaged table that holds the healed actor */
+	void AddHealThreat(const AActor* HealedActor, AActor* Healer, float Healing);
+
+	/**
+	 * Furthest back a rewind may go, bounding how much latency a client can claim
+	 * Keep it within FCombatPositionHistory::MinHistorySeconds; older times clamp to the oldest sample
+	 */
+	float MaxRewindSeconds = 0.5f;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Registered combatants; removal swaps the last entry into the hole */
+	UPROPERTY()
+	TArray<FCombatantEntry> Combatants;
+
+	/** Index into Combatants by actor */
+	TMap<const AActor*, int32> CombatantIndexByActor;
+
+	/** Position history of each combatant, parallel to Combatants */
+	TArray<FCombatPositionHistory> PositionHistories;
+
+	/** Threat tables that currently hold threat, in no particular order */
+	UPROPERTY()
+	TArray<UThreatComponent*> EngagedThreatTables;
+
+private:
+	/** Rebuild the grid if combatants changed or a new frame started since the last rebuild */
+	void UpdateSpatialGrid();
+
+	FCombatSpatialGrid SpatialGrid;
+	uint64 SpatialGridFrame = 0;
+	bool bSpatialGridDirty = true;
+
+	/** Scratch reused by every rebuild and query */
+	TArray<FVector> CombatantPositions;
+	TArray<int32> AreaQueryResults;
+};
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BenchmarkCommandlet.h"
+#include "CombatSimulationCommandlet.generated.h"
+
+class ACombatCharacter;
+class UCombatComponent;
+class UResourceComponent;
+
+/**
+ * Headless deterministic combat simulation
+ * For each population size, spawns ACombatCharacters in small squads in a fresh game world, gives each a
+ * random squad mate as its target and runs a seeded, fixed-timestep fight of melee, ranged and magical attacks
+ * Reports memory per combatant, server frame time percentiles, attacks per second and allocations per attack
+ * Run with: UnrealEditor-Cmd MMORPG.uproject -run=CombatSimulation -nullrhi [-combatants=100,1000,10000]
+ *           [-frames=N] [-tickrate=N] [-seed=N] [-csv=Path]
+ */
+UCLASS()
+class MMORPG_API UCombatSimulationCommandlet : public UBenchmarkCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void ParseParams(const FString& Params) override;
+	virtual void RunScenarios() override;
+	virtual FString GetDefaultCsvName() const override { return TEXT("CombatSimulation.csv"); }
+
+private:
+	/** One simulated fighter and its cached components */
+	struct FSimulatedCombatant
+	{
+		ACombatCharacter* Character = nullptr;
+		UCombatComponent* Combat = nullptr;
+		UResourceComponent* Resources = nullptr;
+		AActor* Target = nullptr;
+	};
+
+	/** Spawn, fight and tear down one population */
+	void RunPopulation(int32 NumCombatants);
+
+	/** Refill every combatant's resources so the fight never stalls on empty pools */
+	void RestoreCombatants();
+
+	TArray<int32> PopulationSizes;
+	int32 NumFrames = 300;
+	int32 TickRate = 30;
+
+	/** Combatants of the population being simulated */
+	TArray<FSimulatedCombatant> Combatants;
+};
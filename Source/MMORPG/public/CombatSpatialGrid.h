@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CombatTypes.h"
+
+struct FAttackAbilityData;
+
+/**
+ * An area to search for combatants, with the constants its shape test needs precomputed
+ * Circles are spheres around Origin; cones and lines start at Origin and point along Direction
+ */
+struct MMORPG_API FCombatAreaQuery
+{
+	EAreaShape Shape = EAreaShape::Circle;
+	FVector Origin = FVector::ZeroVector;
+
+	/** Unit vector; unused by circles */
+	FVector Direction = FVector::ForwardVector;
+
+	/** Circle radius, or cone and line length */
+	float Range = 0.0f;
+
+	float RangeSquared = 0.0f;
+	float ConeCosSquared = 0.0f;
+	float LineHalfWidthSquared = 0.0f;
+
+	static FCombatAreaQuery MakeCircle(const FVector& Origin, float Radius);
+	static FCombatAreaQuery MakeCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngleDegrees);
+	static FCombatAreaQuery MakeLine(const FVector& Origin, const FVector& Direction, float Length, float Width);
+
+	/** Build the query for an area ability at a given range; SingleTarget abilities become a circle of that range */
+	static FCombatAreaQuery MakeForAbility(const FAttackAbilityData& Ability, float Range, const FVector& Origin, const FVector& Direction);
+
+	/** Whether a point lies inside the area */
+	bool Contains(const FVector& Point) const;
+
+	/** Get the area's extent on the ground plane */
+	FBox2D GetBounds() const;
+};
+
+/**
+ * Uniform spatial hash over a set of positions, rebuilt in bulk rather than updated per move
+ * Positions are bucketed by grid cell with a counting sort and stored as separate X, Y and Z arrays,
+ * so a query tests each candidate bucket as contiguous floats, four at a time
+ */
+class MMORPG_API FCombatSpatialGrid
+{
+public:
+	explicit FCombatSpatialGrid(float InCellSize = 500.0f);
+
+	/** Replace the grid's contents; query results are indices into Positions */
+	void Build(TArrayView<const FVector> Positions);
+
+	/**
+	 * Find every position inside an area
+	 * Not thread safe: queries share scratch state
+	 * @param Area The area to search
+	 * @param OutIndices Receives the indices of matching positions, in no particular order; not cleared first
+	 */
+	void Query(const FCombatAreaQuery& Area, TArray<int32>& OutIndices) const;
+
+	/** Get the number of positions in the grid */
+	int32 Num() const { return SortedIndices.Num(); }
+
+	float GetCellSize() const { return CellSize; }
+
+private:
+	int32 GetBucket(int32 CellX, int32 CellY) const;
+	void QueryBucket(const FCombatAreaQuery& Area, int32 Bucket, TArray<int32>& OutIndices) const;
+
+	float CellSize;
+	float InvCellSize;
+	int32 BucketMask = 0;
+
+	/** Entries of bucket B are [BucketStarts[B], BucketStarts[B + 1]) in the sorted arrays */
+	TArray<int32> BucketStarts;
+	TArray<int32> SortedIndices;
+	TArray<float> SortedX;
+	TArray<float> SortedY;
+	TArray<float> SortedZ;
+
+	/** Scratch reused by every build and query */
+	TArray<int32> EntryBuckets;
+	mutable TBitArray<> VisitedBuckets;
+	mutable TArray<int32> VisitedBucketList;
+};
@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Identifies a timer scheduled in an FCombatTimerWheel; stale once the timer fires or is cancelled
+ */
+struct FCombatTimerHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; }
+};
+
+/**
+ * Hierarchical timer wheel counting in whole ticks
+ * Four levels of 64 slots cover about 16.7 million ticks; a timer sits in the coarsest level that can
+ * still tell its slot apart and drops a level each time its slot comes round, so scheduling and
+ * cancelling are O(1) and advancing only touches the slots that come due
+ * Timers live in one pooled node array linked by index, so steady-state use does not allocate
+ */
+class MMORPG_API FCombatTimerWheel
+{
+public:
+	FCombatTimerWheel();
+
+	/**
+	 * Schedule a timer
+	 * @param DelayTicks Ticks from now until it fires; at least one, and clamped to the wheel's span
+	 * @param Payload Returned when the timer fires
+	 */
+	FCombatTimerHandle Schedule(uint64 DelayTicks, uint32 Payload);
+
+	/** Cancel a pending timer; stale handles are ignored. Returns whether a timer was cancelled */
+	bool Cancel(FCombatTimerHandle& Handle);
+
+	/** Check whether a handle still refers to a pending timer */
+	bool IsPending(const FCombatTimerHandle& Handle) const;
+
+	/**
+	 * Advance to a tick, collecting the payloads of every timer that fired on the way in firing order
+	 * @param OutPayloads Receives the fired payloads; not cleared first
+	 */
+	void Advance(uint64 ToTick, TArray<uint32>& OutPayloads);
+
+	uint64 GetCurrentTick() const { return CurrentTick; }
+
+	/** Get the number of pending timers */
+	int32 Num() const { return NumPending; }
+
+	/** Longest delay a timer can be scheduled with */
+	static constexpr uint64 MaxDelayTicks = (uint64(1) << 24) - 1;
+
+private:
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+	static constexpr int32 NumLevels = 4;
+
+	struct FNode
+	{
+		uint64 ExpiryTick = 0;
+		uint32 Payload = 0;
+		uint32 Generation = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+
+		/** Index into SlotHeads, or INDEX_NONE while the node is free */
+		int32 Slot = INDEX_NONE;
+	};
+
+	/** Link a node into the slot its expiry belongs in, relative to the current tick */
+	void Insert(int32 NodeIndex);
+	void Unlink(int32 NodeIndex);
+	void Release(int32 NodeIndex);
+
+	/** Move every timer in a coarse slot down to the levels below */
+	void Cascade(int32 Level);
+
+	TArray<FNode> Nodes;
+	int32 FirstFreeNode = INDEX_NONE;
+	int32 SlotHeads[NumLevels * SlotsPerLevel];
+	uint64 CurrentTick = 0;
+	int32 NumPending = 0;
+};
@@ -28,6 +28,18 @@ enum class EAttackType : uint8
 	MagicalAttack   UMETA(DisplayName = "Magical Attack")
 };
 
+/**
+ * Area an attack hits
+ */
+UENUM(BlueprintType)
+enum class EAreaShape : uint8
+{
+	SingleTarget    UMETA(DisplayName = "Single Target"),
+	Circle          UMETA(DisplayName = "Circle"),
+	Cone            UMETA(DisplayName = "Cone"),
+	Line            UMETA(DisplayName = "Line")
+};
+
 /**
  * Resource types for combat abilities
  */
@@ -39,6 +51,27 @@ enum class EResourceType : uint8
 	Stamina     UMETA(DisplayName = "Stamina")
 };
 
+/** Number of resource types; per-resource storage is indexed by the type's value */
+constexpr int32 NumCombatResourceTypes = 3;
+
+/** Bit for a resource type in a changed-resource mask */
+inline int32 GetResourceBit(EResourceType ResourceType)
+{
+	return 1 << static_cast<int32>(ResourceType);
+}
+
+/**
+ * One amount per resource type: signed deltas applied together by UResourceComponent::ApplyResourceDeltas
+ */
+struct FResourceAmounts
+{
+	float Amounts[NumCombatResourceTypes] = {};
+
+	float Get(EResourceType ResourceType) const { return Amounts[static_cast<int32>(ResourceType)]; }
+	void Add(EResourceType ResourceType, float Amount) { Amounts[static_cast<int32>(ResourceType)] += Amount; }
+	void Set(EResourceType ResourceType, float Amount) { Amounts[static_cast<int32>(ResourceType)] = Amount; }
+};
+
 /**
  * Weapon data structure
  */
@@ -117,11 +150,56 @@ struct FAttackAbilityData
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability")
 	TArray<FResourceCost> ResourceCosts;
 
+	// Area hit around the attacker; Range is the circle radius or the cone and line length
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability")
+	EAreaShape AreaShape;
+
+	// Half of the cone's opening angle in degrees, up to 90
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability", meta = (ClampMin = "0.0", ClampMax = "90.0"))
+	float ConeHalfAngle;
+
+	// Full width of a line attack
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability", meta = (ClampMin = "0.0"))
+	float LineWidth;
+
+	// Speed of the projectile a single-target attack fires; 0 hits instantly
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ability", meta = (ClampMin = "0.0"))
+	float ProjectileSpeed;
+
 	FAttackAbilityData()
 		: AbilityName("Basic Attack")
 		, AttackType(EAttackType::MeleeAttack)
 		, Damage(10.0f)
 		, Range(100.0f)
 		, Cooldown(1.0f)
+		, AreaShape(EAreaShape::SingleTarget)
+		, ConeHalfAngle(30.0f)
+		, LineWidth(100.0f)
+		, ProjectileSpeed(0.0f)
 	{}
 };
+
+/**
+ * Reference to a shared ability definition in the ability registry
+ * Two bytes, so components and RPCs carry it instead of a copy of the ability data
+ */
+USTRUCT(BlueprintType)
+struct FAbilityHandle
+{
+	GENERATED_BODY()
+
+	static constexpr uint16 InvalidIndex = MAX_uint16;
+
+	FAbilityHandle() = default;
+	explicit FAbilityHandle(uint16 InIndex) : Index(InIndex) {}
+
+	bool IsValid() const { return Index != InvalidIndex; }
+	uint16 GetIndex() const { return Index; }
+
+	bool operator==(const FAbilityHandle& Other) const { return Index == Other.Index; }
+	bool operator!=(const FAbilityHandle& Other) const { return Index != Other.Index; }
+
+private:
+	UPROPERTY()
+	uint16 Index = InvalidIndex;
+};
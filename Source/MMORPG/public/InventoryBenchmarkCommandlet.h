@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BenchmarkCommandlet.h"
+#include "InventoryComponent.h"
+#include "InventoryBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless inventory benchmark
+ * Drives a standalone UInventoryComponent through loot bursts, stack churn, sorting, binary and
+ * JSON serialization and clearing at each bag size, and writes ns/op, allocations and peak memory
+ * per scenario and bag size
+ * Serialization rows also report the encoded size, and deserialization rows the slots and resource
+ * counts that did not survive the round trip, which are logged as errors
+ * LootReplication100 loots continuously into a 100-slot bag for a minute of 30 Hz net updates and counts
+ * the bits the owner would receive as a whole replicated array, as rep layout array deltas and as the
+ * fast array of occupied slots. This is a modeled estimate: framing follows the rep layout and fast array
+ * formats, and packet and bunch headers are left out
+ * The Load and CollectGarbage rows keep 10k players' bags loaded at once, first as item IDs and then with
+ * a UItem object per slot, and report memory per player and the time of a full garbage collection
+ * Run with: UnrealEditor-Cmd MMORPG.uproject -run=InventoryBenchmark -nullrhi [-slots=30,300,3000]
+ *           [-players=N] [-iterations=N] [-seed=N] [-csv=Path]
+ */
+UCLASS()
+class MMORPG_API UInventoryBenchmarkCommandlet : public UBenchmarkCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void ParseParams(const FString& Params) override;
+	virtual void RunScenarios() override;
+	virtual FString GetDefaultCsvName() const override { return TEXT("InventoryBenchmark.csv"); }
+
+private:
+	/** Slots and resources of the inventory at one point, to check a round trip against */
+	struct FInventoryContents
+	{
+		TArray<FInventorySlot> Slots;
+		TMap<EResourceType, int32> Resources;
+	};
+
+	/** Run every scenario against a fresh inventory of NumSlots slots, suffixing scenario names with the size */
+	void RunSlotCount(int32 NumSlots);
+
+	/** Loot into a bag at the net update rate and estimate the slot replication bandwidth of each approach */
+	void RunReplicationEstimate();
+
+	/** Load a bag per player, holding item IDs or a unique instance per slot, then time garbage collections over them */
+	void RunPlayerInventories(const TCHAR* Layout, bool bUniqueInstances);
+
+	/** Register the benchmark's item definitions with the item registry */
+	void RegisterBenchmarkItems();
+
+	FInventoryContents CaptureContents() const;
+
+	/** Compare the inventory with what was serialized and add the RoundTripErrors metric, logging an error on any mismatch */
+	void ReportRoundTrip(const TCHAR* Format, const FInventoryContents& Expected, int32 FailedLoads);
+
+	/** Empty the inventory and add NumAdds random stacks */
+	void FillInventory(int32 NumAdds);
+
+	int32 GetRandomItemID();
+	int32 GetRandomStackableItemID();
+
+	/** Bag sizes to run, from -slots */
+	TArray<int32> SlotCounts;
+
+	/** Bags loaded at once for the garbage collection scenarios, from -players */
+	int32 NumPlayers = 10000;
+
+	UPROPERTY()
+	TArray<UInventoryComponent*> PlayerInventories;
+
+	UPROPERTY()
+	UInventoryComponent* Inventory = nullptr;
+};
@@ -5,17 +5,43 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "ResourceTypes.h"
+#include "Item.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "InventoryComponent.generated.h"
 
+class UInventoryComponent;
+struct FReplicatedInventorySlotArray;
+
 /**
- * Component that manages a collection of resources for an actor
-#include "Item.h"
-#include "InventoryComponent.generated.h"
+ * How a slot changed in a replication update received by a client
+ */
+UENUM(BlueprintType)
+enum class EInventorySlotReplication : uint8
+{
+	Added       UMETA(DisplayName = "Added"),
+	Changed     UMETA(DisplayName = "Changed"),
+	Removed     UMETA(DisplayName = "Removed")
+};
+
+/**
+ * How SortInventory rearranges the bag
+ */
+UENUM(BlueprintType)
+enum class EInventorySortMode : uint8
+{
+	ByItemID    UMETA(DisplayName = "By Item ID"),
+	Compact     UMETA(DisplayName = "Compact")
+};
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryChanged, UInventoryComponent*, Inventory);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInventorySlotsChanged, UInventoryComponent*, Inventory, const TArray<int32>&, ChangedSlots);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInventorySorted, UInventoryComponent*, Inventory, const TArray<int32>&, NewSlotForOldSlot);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnInventorySlotReplicated, UInventoryComponent*, Inventory, int32, SlotIndex, EInventorySlotReplication, Change);
 
 /**
  * Structure representing an inventory slot
+ * Stacks are plain {ItemID, Quantity} records resolved through the UItemRegistry;
+ * Instance is set only for unique items that carry their own state
  */
 USTRUCT(BlueprintType)
 struct FInventorySlot
@@ -23,26 +49,165 @@ struct FInventorySlot
 	GENERATED_BODY()
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
-	UItem* Item;
+	int32 ItemID;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
 	int32 Quantity;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	UItem* Instance;
+
 	FInventorySlot()
-		: Item(nullptr)
+		: ItemID(INDEX_NONE)
+		, Quantity(0)
+		, Instance(nullptr)
+	{
+	}
+
+	FInventorySlot(int32 InItemID, int32 InQuantity, UItem* InInstance = nullptr)
+		: ItemID(InItemID)
+		, Quantity(InQuantity)
+		, Instance(InInstance)
+	{
+	}
+
+	bool IsEmpty() const { return Quantity <= 0; }
+
+	/** Whether two slots hold the same kind of item and could share a stack */
+	bool HoldsSameItem(const FInventorySlot& Other) const { return ItemID == Other.ItemID && Instance == Other.Instance; }
+};
+
+/**
+ * An item and a quantity, independent of which slots hold it
+ * Use ItemID for definition items and Instance for unique items, as in FInventorySlot
+ */
+USTRUCT(BlueprintType)
+struct FInventoryItemAmount
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	int32 ItemID;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	int32 Quantity;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	UItem* Instance;
+
+	FInventoryItemAmount()
+		: ItemID(INDEX_NONE)
 		, Quantity(0)
+		, Instance(nullptr)
 	{
 	}
 
-	FInventorySlot(UItem* InItem, int32 InQuantity)
-		: Item(InItem)
+	FInventoryItemAmount(int32 InItemID, int32 InQuantity, UItem* InInstance = nullptr)
+		: ItemID(InItemID)
 		, Quantity(InQuantity)
+		, Instance(InInstance)
+	{
+	}
+};
+
+/**
+ * A batch of item adds and removes applied as one unit
+ * Removes are applied before adds, so slots they free can hold the added items
+ */
+USTRUCT(BlueprintType)
+struct FInventoryTransaction
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	TArray<FInventoryItemAmount> ItemsToRemove;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Inventory")
+	TArray<FInventoryItemAmount> ItemsToAdd;
+};
+
+/**
+ * Replicated form of an occupied slot
+ * Stacks travel as ItemIDs and are resolved through the UItemRegistry on the receiving side;
+ * unique instances also carry their class and properties
+ */
+USTRUCT()
+struct FReplicatedInventorySlot : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 SlotIndex = INDEX_NONE;
+
+	UPROPERTY()
+	int32 ItemID = 0;
+
+	UPROPERTY()
+	int32 Quantity = 0;
+
+	/** Class and properties of a unique instance, empty for stacks; the receiver creates its own copy */
+	UPROPERTY()
+	TArray<uint8> InstanceData;
+
+	void PreReplicatedRemove(const FReplicatedInventorySlotArray& InArraySerializer);
+	void PostReplicatedAdd(const FReplicatedInventorySlotArray& InArraySerializer);
+	void PostReplicatedChange(const FReplicatedInventorySlotArray& InArraySerializer);
+};
+
+/**
+ * Fast array of occupied slots, so only slots that changed are sent
+ */
+USTRUCT()
+struct FReplicatedInventorySlotArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FReplicatedInventorySlot> Entries;
+
+	/** Component that receives the replicated changes */
+	UPROPERTY(NotReplicated)
+	UInventoryComponent* Owner = nullptr;
+
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
 	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FReplicatedInventorySlot, FReplicatedInventorySlotArray>(Entries, DeltaParms, *this);
 	}
 };
 
+template<>
+struct TStructOpsTypeTraits<FReplicatedInventorySlotArray> : public TStructOpsTypeTraitsBase2<FReplicatedInventorySlotArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Slots occupied by a single item definition, kept in ascending slot order
+ * Lets stacking and lookups visit only the slots that hold the item
+ */
+struct FInventoryItemSlots
+{
+	/** Hot fields copied from the registry when the item enters the bag */
+	float Weight = 0.0f;
+	int32 StackLimit = 1;
+
+	/** Every slot holding the item */
+	TArray<int32> Slots;
+
+	/** Subset of Slots whose stack is below StackLimit */
+	TArray<int32> PartialSlots;
+
+	/** Sum of the quantities in Slots */
+	int32 TotalQuantity = 0;
+};
+
 /**
- * Component that manages an inventory of items
+ * Component that manages an inventory of items and gathered resources
  * Handles adding, removing, and sorting items
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
@@ -50,20 +215,24 @@ class MMORPG_API UInventoryComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
-public:	
 public:
 	UInventoryComponent();
 
 protected:
 	virtual void BeginPlay() override;
 
-public:	
-	/**
-	 * Map of resource types to their quantities
-	 */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory")
-	TMap<EResourceType, int32> ResourceInventory;
+	// Networking support
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Occupied slots replicated to the owning client only */
+	UPROPERTY(Replicated)
+	FReplicatedInventorySlotArray ReplicatedSlots;
 
+	/** Forward a sort permutation to the owning client */
+	UFUNCTION(Client, Reliable)
+	void ClientInventorySorted(const TArray<int32>& NewSlotForOldSlot);
+
+public:
 	/**
 	 * Maximum stack size for a single resource type (0 = unlimited)
 	 */
@@ -114,7 +283,45 @@ public:
 	bool HasResource(EResourceType ResourceType, int32 MinQuantity = 1) const;
 
 	/**
-	 * Clear all resources from the inventory
+	 * Get all resources in the inventory
+	 * Built on demand from the per-type counters; prefer GetResourceQuantity in C++
+	 * @return Map of every resource held and its quantity
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory")
+	TMap<EResourceType, int32> GetAllResources() const;
+
+	/**
+	 * Add several resources at once, each clamped to MaxStackSize as in AddResource
+	 * @param Resources - The resources to add; a type may appear more than once
+	 * @return True if every entry was valid and had room for at least part of its quantity
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool AddResources(const TArray<FResourceItem>& Resources);
+
+	/**
+	 * Remove several resources at once; either every quantity is removed or nothing is
+	 * @param Resources - The resources to remove; a type may appear more than once
+	 * @return True if the resources were removed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool RemoveResources(const TArray<FResourceItem>& Resources);
+
+	/**
+	 * Check if the inventory holds every listed resource quantity
+	 * @param Resources - The required resources; repeated types are summed
+	 * @return True if all requirements are met
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory")
+	bool HasResources(const TArray<FResourceItem>& Resources) const;
+
+	/**
+	 * Get the quantities of several resource types
+	 * @param ResourceTypes - The types to query
+	 * @return One quantity per requested type, in the same order
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory")
+	TArray<int32> GetResourceQuantities(const TArray<EResourceType>& ResourceTypes) const;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Inventory")
 	int32 MaxSlots;
 
@@ -132,8 +339,47 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Inventory")
 	FOnInventoryChanged OnInventoryChanged;
 
+	// Event fired alongside OnInventoryChanged with the indices of the slots that were written
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnInventorySlotsChanged OnInventorySlotsChanged;
+
+	// Event fired on clients for each slot added, changed or removed by replication
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnInventorySlotReplicated OnSlotReplicated;
+
+	// Event fired after a sort with the slot each old slot's items moved to (INDEX_NONE for empty slots)
+	// Also fired on the owning client so it can animate the move instead of redrawing every slot
+	UPROPERTY(BlueprintAssignable, Category = "Inventory")
+	FOnInventorySorted OnInventorySorted;
+
+	/** Apply one replicated slot on a client; the batch is broadcast by FlushReplicatedSlots */
+	void HandleReplicatedSlot(const FReplicatedInventorySlot& Entry, EInventorySlotReplication Change);
+
+	/** Broadcast every slot received in the last replication update as one change */
+	void FlushReplicatedSlots();
+
+	/**
+	 * Apply a batch of adds and removes atomically
+	 * Capacity and weight are checked once for the whole batch; on failure nothing is changed
+	 * Fires a single change event listing every slot written
+	 * @param Transaction The items to remove and add
+	 * @return True if the whole transaction was applied
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool ApplyTransaction(const FInventoryTransaction& Transaction);
+
+	/**
+	 * Check whether a transaction would succeed without applying it
+	 * @param Transaction The items to remove and add
+	 * @return True if ApplyTransaction would succeed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool CanApplyTransaction(const FInventoryTransaction& Transaction) const;
+
 	/**
 	 * Add an item to the inventory
+	 * Registered definitions are stored by ItemID; any other item is stored as a unique instance
+	 * Either the full quantity is added or nothing is
 	 * @param Item The item to add
 	 * @param Quantity The quantity to add
 	 * @return True if the item was successfully added
@@ -159,6 +405,33 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	bool RemoveItemFromSlot(int32 SlotIndex, int32 Quantity = 1);
 
+	/**
+	 * Add items by ItemID without an item object
+	 * Either the full quantity is added or nothing is
+	 * @param ItemID The registered item definition to add
+	 * @param Quantity The quantity to add
+	 * @return True if the items were successfully added
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool AddItemByID(int32 ItemID, int32 Quantity = 1);
+
+	/**
+	 * Remove items by ItemID; unique instances with that ID are not touched
+	 * @param ItemID The item definition to remove
+	 * @param Quantity The quantity to remove
+	 * @return True if the items were successfully removed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool RemoveItemByID(int32 ItemID, int32 Quantity = 1);
+
+	/**
+	 * Get the total quantity stacked under an ItemID, excluding unique instances
+	 * @param ItemID The item definition to count
+	 * @return The total quantity
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	int32 GetItemQuantityByID(int32 ItemID) const;
+
 	/**
 	 * Get an item from a specific slot
 	 * @param SlotIndex The index of the slot
@@ -167,6 +440,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	FInventorySlot GetItemAtSlot(int32 SlotIndex) const;
 
+	/**
+	 * Get the item object for a slot: its unique instance, or the shared definition
+	 * @param SlotIndex The index of the slot
+	 * @return The item, or nullptr if the slot is empty
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	UItem* GetSlotItem(int32 SlotIndex) const;
+
 	/**
 	 * Find an item in the inventory
 	 * @param Item The item to find
@@ -193,10 +474,12 @@ public:
 	int32 GetItemQuantity(UItem* Item) const;
 
 	/**
-	 * Sort the inventory
+	 * Sort the inventory by item ID, largest stacks first, with empty slots packed at the end
+	 * Only slots whose contents changed are marked dirty and replicated
+	 * @param Mode Compact also merges partial stacks of the same item up to its stack limit
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
-	void SortInventory();
+	void SortInventory(EInventorySortMode Mode = EInventorySortMode::ByItemID);
 
 	/**
 	 * Get the number of empty slots
@@ -225,14 +508,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	void ClearInventory();
 
-	/**
-	 * Get all resources in the inventory
-	 * @return Map of all resources and their quantities
-	 */
-	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory")
-	TMap<EResourceType, int32> GetAllResources() const { return ResourceInventory; }
 	// Persistent storage stubs for future SpacetimeDB integration
-	
+
 	/**
 	 * Save inventory state to persistent storage
 	 * Stub for future SpacetimeDB integration
@@ -249,20 +526,194 @@ public:
 
 	/**
 	 * Serialize inventory to a JSON string
-	 * Helper for persistence
+	 * Human-readable debug export; persistence uses the binary form
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
 	FString SerializeInventory() const;
 
 	/**
-	 * Deserialize inventory from a JSON string
-	 * Helper for persistence
+	 * Deserialize inventory from a JSON string produced by SerializeInventory
+	 * @param JsonString The exported inventory
+	 * @return True if the inventory was restored; on failure it is left unchanged
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
 	bool DeserializeInventory(const FString& JsonString);
 
+	/**
+	 * Serialize slots and resources to the compact, versioned binary format
+	 * Occupied slots are stored as packed (slot gap, ItemID, quantity) triples; unique instances are
+	 * tagged in the quantity and followed by their class and saved properties
+	 * @param OutData Receives the encoded inventory
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
+	void SerializeInventoryBinary(TArray<uint8>& OutData) const;
+
+	/**
+	 * Deserialize inventory from data produced by SerializeInventoryBinary
+	 * @param Data The encoded inventory
+	 * @return True if the inventory was restored; on failure it is left unchanged
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
+	bool DeserializeInventoryBinary(const TArray<uint8>& Data);
+
+	/**
+	 * Encode every slot changed since the last acknowledged snapshot, plus resources if they changed
+	 * Deltas are cumulative until acknowledged, so a lost write is covered by the next delta
+	 * @param OutData Receives the encoded delta
+	 * @return The snapshot version this delta brings storage up to
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
+	int32 BuildInventoryDelta(TArray<uint8>& OutData);
+
+	/**
+	 * Confirm that storage holds the given snapshot version, so its slots stop being resent
+	 * @param Version A version returned by BuildInventoryDelta
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
+	void AcknowledgeInventorySnapshot(int32 Version);
+
+	/**
+	 * Apply a delta produced by BuildInventoryDelta on top of a loaded snapshot
+	 * Deltas at or below the current version are skipped as already applied
+	 * @param Data The encoded delta
+	 * @return False if the delta is malformed or starts after the current version
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
+	bool ApplyInventoryDelta(const TArray<uint8>& Data);
+
+	/** Get the version of the last snapshot or delta produced or loaded */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory|Persistence")
+	int32 GetSnapshotVersion() const { return SnapshotVersion; }
+
+	/** Get the number of slots changed since the last acknowledged snapshot */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory|Persistence")
+	int32 GetDirtySlotCount() const { return DirtySlots.Num(); }
+
 private:
+	/** Quantity held of each resource type */
+	FResourceCounts ResourceCounts;
+
+	/** Slots occupied by each item definition currently in the inventory */
+	TMap<int32, FInventoryItemSlots> ItemSlotIndex;
+
+	/** Slot holding each unique item instance */
+	TMap<const UItem*, int32> InstanceSlotIndex;
+
+	/** Min-heap of empty slot indices, so the lowest free slot is always on top */
+	TArray<int32> FreeSlotHeap;
+
+	/** Per slot, its index in ReplicatedSlots.Entries, or INDEX_NONE if the slot is empty */
+	TArray<int32> ReplicatedEntryIndices;
+
+	/** Slots received from the server that have not been broadcast yet */
+	TArray<int32> PendingReplicatedSlots;
+
+	/** Version of the last delta built or snapshot loaded */
+	int32 SnapshotVersion = 0;
+
+	/** Highest version storage has confirmed */
+	int32 AcknowledgedVersion = 0;
+
+	/** Slots changed since AcknowledgedVersion, unordered, with membership flags to avoid duplicates */
+	TArray<int32> DirtySlots;
+	TBitArray<> DirtySlotFlags;
+
+	/** Per slot, the snapshot version its latest change will be written in */
+	TArray<int32> SlotDirtyVersions;
+
+	/** Snapshot version the latest resource change will be written in, or 0 if resources are clean */
+	int32 ResourcesDirtyVersion = 0;
+
+	/** Running weight total; CurrentWeight mirrors it, kept in double so add/remove churn doesn't drift */
+	double WeightAccumulator = 0.0;
+
+	/** Recompute the weight from every slot; only needed after the index is rebuilt */
 	void UpdateWeight();
 	int32 FindEmptySlot() const;
-	int32 FindStackableSlot(UItem* Item) const;
+	int32 FindStackableSlot(int32 ItemID) const;
+
+	/** Index entry for an item definition, created with the registry's hot fields on first use */
+	FInventoryItemSlots& FindOrAddItemEntry(int32 ItemID);
+
+	/**
+	 * Write a slot and keep the item and free-slot indices in sync
+	 * Every slot mutation must go through here; a non-positive quantity empties the slot
+	 * Stacks must use an ItemID the registry knows
+	 */
+	void SetSlotContents(int32 SlotIndex, const FInventorySlot& NewContents);
+
+	/** Rebuild the item and free-slot indices from InventorySlots */
+	void RebuildSlotIndex();
+
+	/** Rebuild only the item, instance and free-slot indices; the bag size must be unchanged */
+	void RebuildItemIndices();
+
+	/** Take an amount from its slots in ascending order; the caller has checked the total */
+	void RemoveFromSlots(const FInventoryItemAmount& Amount, TArray<int32>& OutChangedSlots);
+
+	/** Top up partial stacks, then fill free slots; the caller has checked capacity */
+	void AddToSlots(const FInventoryItemAmount& Amount, TArray<int32>& OutChangedSlots);
+
+	/** Describe an item object as a definition stack or a unique instance, registering a stackable item with no definition */
+	FInventoryItemAmount MakeItemAmount(UItem* Item, int32 Quantity) const;
+
+	/** Weight of one unit of a slot's or amount's item, or a negative value if it has no definition */
+	float GetUnitWeight(int32 ItemID, const UItem* Instance) const;
+
+	/** Largest quantity one slot may hold of an item; unique instances never stack */
+	int32 GetStackLimit(int32 ItemID, const UItem* Instance) const;
+
+	/**
+	 * Validate a transaction against the current contents without changing them
+	 * @param OutRemoves Removes summed per item
+	 * @param OutAdds Adds summed per item
+	 * @return True if every remove is covered and every add fits by slots and weight
+	 */
+	bool PlanTransaction(const FInventoryTransaction& Transaction,
+		TArray<FInventoryItemAmount>& OutRemoves, TArray<FInventoryItemAmount>& OutAdds) const;
+
+	/** Fire OnInventorySlotsChanged and OnInventoryChanged once for a finished mutation */
+	void BroadcastSlotsChanged(TArray<int32>& ChangedSlots);
+
+	/** Broadcast a change covering every slot, for whole-bag operations */
+	void BroadcastAllSlotsChanged();
+
+	/** Whether an ItemID read from storage or the network can be placed in a slot */
+	static bool IsKnownItemID(int32 ItemID);
+
+	/** Replace the whole contents with a decoded inventory and broadcast the change */
+	void RestoreInventory(TArray<FInventorySlot>& NewSlots, const FResourceCounts& NewResources, int32 Version);
+
+	/** Add to one counter without marking it dirty; false if the type is invalid or already at MaxStackSize */
+	bool AddResourceQuantity(EResourceType ResourceType, int32 Quantity);
+
+	/** Write the non-zero resource counters as packed (type, quantity) pairs */
+	void WriteResourceCounts(FArchive& Writer) const;
+
+	/** Read counters written by WriteResourceCounts */
+	static bool ReadResourceCounts(FArchive& Reader, FResourceCounts& OutResources);
+
+	void MarkSlotDirty(int32 SlotIndex);
+	void MarkAllSlotsDirty();
+	void MarkResourcesDirty();
+
+	/** Treat the current contents as exactly what storage holds at Version */
+	void ResetDirtyTracking(int32 Version);
+
+	/** Whether this instance owns the replicated slot list (server or standalone) */
+	bool WritesReplicatedSlots() const;
+
+	/** Mirror a slot write into ReplicatedSlots, marking only that entry dirty */
+	void UpdateReplicatedSlot(int32 SlotIndex);
+
+	/** Regenerate ReplicatedSlots from InventorySlots after whole-bag changes */
+	void RebuildReplicatedSlots();
+
+	static bool IsPartialStack(const FInventoryItemSlots& Entry, int32 Quantity);
+
+	/**
+	 * Compare the running weight, empty-slot count and per-item totals against a full recompute
+	 * Logs every mismatch; called through checkSlow so it only runs in debug builds
+	 */
+	bool IsAccountingConsistent() const;
 };
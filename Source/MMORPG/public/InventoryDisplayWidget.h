@@ -6,6 +6,8 @@
 #include "Blueprint/UserWidget.h"
 #include "InventoryDisplayWidget.generated.h"
 
+class UInventoryComponent;
+
 /**
  * Simple inventory item structure for placeholder data
  */
@@ -56,9 +58,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	void RefreshInventory();
 
+	// Add a placeholder item; fails while an inventory component is bound, since it owns the slots
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	bool AddItem(const FInventoryItem& Item);
 
+	// Empty a slot; while an inventory component is bound, removes the slot's items from it
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	bool RemoveItem(int32 SlotIndex);
 
@@ -71,6 +75,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	bool IsInventoryFull() const;
 
+	// Display an inventory component's slots and refresh only the slots it reports as changed
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void BindToInventory(UInventoryComponent* Inventory);
+
+	// Called after every slot was refreshed, such as on bind or when the bag is resized; rebuild the whole grid
+	UFUNCTION(BlueprintImplementableEvent, Category = "Inventory")
+	void OnInventoryRefreshed();
+
+	// Called after one slot of the bound inventory changed; redraw only that slot from InventoryItems
+	UFUNCTION(BlueprintImplementableEvent, Category = "Inventory")
+	void OnSlotRefreshed(int32 SlotIndex);
+
 	// Persistent storage stubs (for future implementation)
 	UFUNCTION(BlueprintCallable, Category = "Inventory|Persistence")
 	void SaveInventoryData();
@@ -80,7 +96,17 @@ public:
 
 protected:
 	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+
+	// Inventory component currently displayed, if any
+	UPROPERTY()
+	UInventoryComponent* BoundInventory = nullptr;
 
 private:
 	void InitializePlaceholderInventory();
+
+	UFUNCTION()
+	void OnInventorySlotsChanged(UInventoryComponent* Inventory, const TArray<int32>& ChangedSlots);
+
+	void RefreshSlot(int32 SlotIndex);
 };
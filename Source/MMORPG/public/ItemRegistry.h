@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/DataTable.h"
+#include "ItemRegistry.generated.h"
+
+class UItem;
+
+/**
+ * Data table row describing an item definition
+ */
+USTRUCT(BlueprintType)
+struct FItemDefinitionRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	int32 ItemID = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	FString ItemName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	FString Description;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	float Weight = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	int32 Value = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	int32 MaxStackSize = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	bool bIsStackable = false;
+
+	/** Class instantiated for the shared definition object; defaults to UItem */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item")
+	TSubclassOf<UItem> ItemClass;
+};
+
+/**
+ * Fields inventory math reads per stack, stored contiguously apart from the UItem objects
+ */
+struct FItemHotData
+{
+	float Weight = 0.0f;
+
+	/** Largest quantity one slot may hold; 1 for non-stackable items */
+	int32 StackLimit = 1;
+};
+
+/**
+ * Item Registry Subsystem
+ * Owns one immutable definition per ItemID, loaded once from data
+ * Inventories store ItemIDs and look definitions up here instead of holding item objects
+ */
+UCLASS(Config = Game)
+class MMORPG_API UItemRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Register every row of an item definition table */
+	UFUNCTION(BlueprintCallable, Category = "Item Registry")
+	void LoadDefinitions(UDataTable* DefinitionTable);
+
+	/**
+	 * Register an item as the definition for its ItemID; call during startup on the server and every client
+	 * Definitions are immutable, so an ItemID that already has one is rejected. An item owned by anything but
+	 * the registry is copied into it, so a definition never keeps a world alive
+	 * @return The registered definition to pass to inventories, or nullptr if the item was rejected
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Item Registry")
+	UItem* RegisterItem(UItem* Item);
+
+	/** Find the definition registered under an ItemID, or nullptr if none is */
+	UFUNCTION(BlueprintCallable, Category = "Item Registry")
+	UItem* FindItemByID(int32 ItemID) const;
+
+	/** Check whether an item is the shared definition for its ItemID rather than a unique instance */
+	UFUNCTION(BlueprintCallable, Category = "Item Registry")
+	bool IsDefinition(const UItem* Item) const;
+
+	/** Find the hot fields for an ItemID, or nullptr if it has no definition */
+	const FItemHotData* FindHotData(int32 ItemID) const;
+
+	/** Get the number of registered definitions */
+	UFUNCTION(BlueprintCallable, Category = "Item Registry")
+	int32 GetNumDefinitions() const { return Definitions.Num(); }
+
+	/** Get the registry from the running engine */
+	static UItemRegistry* Get();
+
+protected:
+	/** Definition table loaded when the subsystem starts */
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> ItemDefinitionTable;
+
+	/** Shared definition objects */
+	UPROPERTY()
+	TArray<UItem*> Definitions;
+
+	/** Hot fields, parallel to Definitions */
+	TArray<FItemHotData> HotData;
+
+	/** Index into Definitions and HotData by ItemID */
+	TMap<int32, int32> DefinitionIndexByID;
+
+	static FItemHotData MakeHotData(const UItem* Item);
+};
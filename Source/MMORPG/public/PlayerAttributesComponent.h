@@ -3,45 +3,47 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Components/ActorComponent.h"
+#include "ResourceComponent.h"
 #include "PlayerAttributesComponent.generated.h"
 
 /**
  * Component that manages persistent player attributes such as XP, HP, Mana, Stamina, and Credits.
+ * HP, Mana and Stamina are the resources of the UResourceComponent this extends, so combat, equipment and
+ * the UI share one replicated attribute array instead of keeping two copies in step.
+ * The owning player receives exact values; other players receive the quantized view, and never XP or Credits.
  * Designed to be modular and support networking and persistence.
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
-class MMORPG_API UPlayerAttributesComponent : public UActorComponent
+class MMORPG_API UPlayerAttributesComponent : public UResourceComponent
 {
 	GENERATED_BODY()
 
 public:
 	UPlayerAttributesComponent();
 
-	// Initialize default values
-	virtual void BeginPlay() override;
+	virtual void PostLoad() override;
 
 	// Getters for attributes
 	UFUNCTION(BlueprintPure, Category = "Attributes")
 	float GetXP() const { return CurrentXP; }
 
 	UFUNCTION(BlueprintPure, Category = "Attributes")
-	float GetHP() const { return CurrentHP; }
+	float GetHP() const { return GetCurrentResource(EResourceType::Health); }
 
 	UFUNCTION(BlueprintPure, Category = "Attributes")
-	float GetMaxHP() const { return MaxHP; }
+	float GetMaxHP() const { return GetMaxResource(EResourceType::Health); }
 
 	UFUNCTION(BlueprintPure, Category = "Attributes")
-	float GetMana() const { return CurrentMana; }
+	float GetMana() const { return GetCurrentResource(EResourceType::Mana); }
 
 	UFUNCTION(BlueprintPure, Category = "Attributes")
-	float GetMaxMana() const { return MaxMana; }
+	float GetMaxMana() const { return GetMaxResource(EResourceType::Mana); }
 
 	UFUNCTION(BlueprintPure, Category = "Attributes")
-	float GetStamina() const { return CurrentStamina; }
+	float GetStamina() const { return GetCurrentResource(EResourceType::Stamina); }
 
 	UFUNCTION(BlueprintPure, Category = "Attributes")
-	float GetMaxStamina() const { return MaxStamina; }
+	float GetMaxStamina() const { return GetMaxResource(EResourceType::Stamina); }
 
 	UFUNCTION(BlueprintPure, Category = "Attributes")
 	int32 GetCredits() const { return Credits; }
@@ -65,7 +67,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Attributes")
 	bool SpendCredits(int32 Amount);
 
-	// Equipment modifier hooks
+	// Equipment modifier hooks; each sets the total modifier to that maximum
 	UFUNCTION(BlueprintCallable, Category = "Attributes")
 	void ApplyMaxHPModifier(float Modifier);
 
@@ -75,55 +77,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Attributes")
 	void ApplyMaxStaminaModifier(float Modifier);
 
-	UFUNCTION(BlueprintCallable, Category = "Attributes")
-	void RecalculateMaxValues();
+	// Kept so existing Blueprint calls still compile; maximums are computed on read
+	UFUNCTION(BlueprintCallable, Category = "Attributes", meta = (DeprecatedFunction, DeprecationMessage = "Maximums are computed on read, so there is nothing to recalculate"))
+	void RecalculateMaxValues() {}
 
 protected:
-	// Base persistent attributes
+	// Base persistent attributes; push-replicated, so change them through the functions above
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Attributes|Persistent")
 	float CurrentXP;
 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Attributes|Persistent")
-	float CurrentHP;
-
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Attributes|Persistent")
-	float CurrentMana;
-
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Attributes|Persistent")
-	float CurrentStamina;
-
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Attributes|Persistent")
 	int32 Credits;
 
-	// Base max values (before modifiers)
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes|Base")
-	float BaseMaxHP;
-
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes|Base")
-	float BaseMaxMana;
-
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attributes|Base")
-	float BaseMaxStamina;
-
-	// Current max values (after modifiers)
-	UPROPERTY(BlueprintReadOnly, Category = "Attributes|Current")
-	float MaxHP;
-
-	UPROPERTY(BlueprintReadOnly, Category = "Attributes|Current")
-	float MaxMana;
-
-	UPROPERTY(BlueprintReadOnly, Category = "Attributes|Current")
-	float MaxStamina;
-
-	// Equipment modifiers
-	UPROPERTY(BlueprintReadOnly, Category = "Attributes|Modifiers")
-	float EquipmentMaxHPModifier;
+	// Base maximums saved before HP, Mana and Stamina moved into the resource attributes; core redirects load
+	// the old BaseMaxHP, BaseMaxMana and BaseMaxStamina here, and PostLoad moves them into Attributes
+	// Negative when nothing was saved
+	UPROPERTY()
+	float BaseMaxHP_DEPRECATED = -1.0f;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Attributes|Modifiers")
-	float EquipmentMaxManaModifier;
+	UPROPERTY()
+	float BaseMaxMana_DEPRECATED = -1.0f;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Attributes|Modifiers")
-	float EquipmentMaxStaminaModifier;
+	UPROPERTY()
+	float BaseMaxStamina_DEPRECATED = -1.0f;
 
 	// Networking support
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
@@ -7,10 +7,119 @@
 #include "CombatTypes.h"
 #include "ResourceComponent.generated.h"
 
+class UPackageMap;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnResourceChanged, EResourceType, ResourceType, float, CurrentValue, float, MaxValue);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnResourcesChanged, int32, ChangedResourceMask);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnResourceThresholdCrossed, EResourceType, ResourceType, float, ThresholdFraction, bool, bRising);
+
+/**
+ * One resource's stored state: its maximum is the base plus the equipment modifier
+ */
+USTRUCT(BlueprintType)
+struct FResourceAttribute
+{
+	GENERATED_BODY()
+
+	// Maximum before modifiers
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	float BaseMax = 100.0f;
+
+	// Sum of equipment modifiers to the maximum
+	UPROPERTY(BlueprintReadOnly, Category = "Resource")
+	float Modifier = 0.0f;
+
+	// Value as of UpdateTime; read through UResourceComponent::GetCurrentResource to include regeneration
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	float Current = 100.0f;
+
+	// Regeneration per second; negative rates drain the resource
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	float RegenRate = 0.0f;
+
+	// Local world time Current was last brought up to date; clients set it on receipt
+	UPROPERTY(NotReplicated)
+	double UpdateTime = 0.0;
+
+	float GetMax() const { return FMath::Max(0.0f, BaseMax + Modifier); }
+};
+
+/**
+ * What players other than the owner need to draw a resource: its maximum and regeneration rate
+ * Changes only with equipment and buffs, so it is replicated apart from the fill levels
+ */
+USTRUCT()
+struct FSimulatedResource
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float Max = 100.0f;
+
+	UPROPERTY()
+	float RegenRate = 0.0f;
+};
+
+/**
+ * Every resource's fill level as a fraction of its maximum, quantized to 10 bits per resource
+ * 1023 steps resolve a 0.1% change, finer than a pixel on any health bar or nameplate, and all three
+ * resources fit in 30 bits against 96 for the full-precision values
+ */
+USTRUCT()
+struct FQuantizedResourceFractions
+{
+	GENERATED_BODY()
+
+	static constexpr int32 NumBits = 10;
+	static constexpr uint32 MaxSteps = (1u << NumBits) - 1;
+
+	void SetFraction(int32 Index, float Fraction) { Steps[Index] = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Fraction, 0.0f, 1.0f) * MaxSteps)); }
+	float GetFraction(int32 Index) const { return static_cast<float>(Steps[Index]) / MaxSteps; }
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FQuantizedResourceFractions& Other) const { return FMemory::Memcmp(Steps, Other.Steps, sizeof(Steps)) == 0; }
+
+private:
+	uint16 Steps[NumCombatResourceTypes] = {};
+};
+
+template<>
+struct TStructOpsTypeTraits<FQuantizedResourceFractions> : public TStructOpsTypeTraitsBase2<FQuantizedResourceFractions>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+/**
+ * A fraction of a resource's maximum that fires an event when crossed, such as full (1.0) or low (0.2)
+ */
+USTRUCT(BlueprintType)
+struct FResourceThreshold
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resource")
+	EResourceType ResourceType = EResourceType::Health;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resource", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Fraction = 1.0f;
+};
 
 /**
  * Component that manages character resources (HP, Mana, Stamina)
+ * Every resource lives in one packed, replicated attribute array indexed by EResourceType, so combat,
+ * equipment and the UI read the same values and clients receive them through a single OnRep
+ * Replication is push-based: the array is only compared for sending after a change marks it dirty. With
+ * bQuantizeForNonOwners, only the owner receives the full-precision array; everyone else receives 10-bit
+ * fill levels plus the maximums and rates, which change rarely, and rebuilds the attributes from those
+ * Does not tick: regeneration is evaluated lazily. Each resource stores its value at the last update time,
+ * and reads add the regeneration since then. Changes settle the value first. While a resource regenerates,
+ * one world timer is armed for the next subscribed threshold it will cross, so regeneration itself costs
+ * nothing per frame
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class MMORPG_API UResourceComponent : public UActorComponent
@@ -21,6 +130,7 @@ public:
 	UResourceComponent();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// Get current value of a resource
 	UFUNCTION(BlueprintCallable, Category = "Resources")
@@ -46,36 +156,113 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Resources")
 	bool HasEnoughResources(const TArray<FResourceCost>& Costs) const;
 
-	// Consume multiple resources - returns true if all successful
+	// Consume multiple resources at once - returns true if all successful
+	// Costs of the same type add up before validation; one OnResourcesChanged covers every change
 	UFUNCTION(BlueprintCallable, Category = "Resources")
 	bool ConsumeResources(const TArray<FResourceCost>& Costs);
 
-	// Event fired when any resource changes
+	// Restore multiple resources at once with a single OnResourcesChanged
+	UFUNCTION(BlueprintCallable, Category = "Resources")
+	void RestoreResources(const TArray<FResourceCost>& Amounts);
+
+	/**
+	 * Apply signed changes to several resources with one validation and one notification
+	 * @param Deltas Change per resource type; negative consumes
+	 * @param bRequireEnough Fail without changing anything if any resource would drop below zero; otherwise clamp at zero
+	 * @return False if bRequireEnough and a resource was short
+	 */
+	bool ApplyResourceDeltas(const FResourceAmounts& Deltas, bool bRequireEnough);
+
+	// Check whether a changed-resource mask from OnResourcesChanged includes a resource
+	UFUNCTION(BlueprintPure, Category = "Resources")
+	static bool IsResourceInMask(int32 ChangedResourceMask, EResourceType ResourceType) { return (ChangedResourceMask & GetResourceBit(ResourceType)) != 0; }
+
+	// Get a resource's regeneration per second; negative rates drain it
+	UFUNCTION(BlueprintCallable, Category = "Resources")
+	float GetResourceRegenRate(EResourceType ResourceType) const;
+
+	// Set a resource's regeneration per second, keeping what has regenerated so far
+	UFUNCTION(BlueprintCallable, Category = "Resources")
+	void SetResourceRegenRate(EResourceType ResourceType, float RatePerSecond);
+
+	// Set the total modifier to a resource's maximum, clamping the current value to the new maximum
+	UFUNCTION(BlueprintCallable, Category = "Resources")
+	void SetMaxResourceModifier(EResourceType ResourceType, float Modifier);
+
+	// Subscribe OnResourceThresholdCrossed to a fraction of a resource's maximum
+	UFUNCTION(BlueprintCallable, Category = "Resources")
+	void AddResourceThreshold(EResourceType ResourceType, float Fraction);
+
+	// Event fired once per batch of changes with a mask of the resources whose value or maximum changed,
+	// locally or by replication; regeneration does not fire it
+	UPROPERTY(BlueprintAssignable, Category = "Resources")
+	FOnResourcesChanged OnResourcesChanged;
+
+	// Event fired for each resource in a batch after OnResourcesChanged, for listeners that only want one resource
 	UPROPERTY(BlueprintAssignable, Category = "Resources")
 	FOnResourceChanged OnResourceChanged;
 
+	// Event fired when a resource crosses one of ResourceThresholds, whether by a change or by regeneration
+	UPROPERTY(BlueprintAssignable, Category = "Resources")
+	FOnResourceThresholdCrossed OnResourceThresholdCrossed;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// The replicated state as the next net update reads it, for tools that account for bandwidth
+	const TArray<FResourceAttribute>& GetAttributes() const { return Attributes; }
+	const FQuantizedResourceFractions& GetQuantizedFractions() const { return QuantizedFractions; }
+	const TArray<FSimulatedResource>& GetSimulatedResources() const { return SimulatedResources; }
+
 protected:
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resources")
-	float MaxHealth;
+	// Every resource's state, indexed by EResourceType
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_Attributes, Category = "Resources", meta = (EditFixedSize))
+	TArray<FResourceAttribute> Attributes;
+
+	// Send full precision to the owning player only, and quantized fill levels to everyone else
+	// Read from the class defaults when the replication layout is built, so it cannot change in play
+	UPROPERTY(EditDefaultsOnly, Category = "Resources|Replication")
+	bool bQuantizeForNonOwners = false;
+
+	// Fill levels replicated to non-owners when bQuantizeForNonOwners is set
+	UPROPERTY(ReplicatedUsing = OnRep_SimulatedResources)
+	FQuantizedResourceFractions QuantizedFractions;
+
+	// Maximums and rates replicated to non-owners when bQuantizeForNonOwners is set, indexed by EResourceType
+	UPROPERTY(ReplicatedUsing = OnRep_SimulatedResources)
+	TArray<FSimulatedResource> SimulatedResources;
+
+	// Fractions of each resource that fire OnResourceThresholdCrossed
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resources")
+	TArray<FResourceThreshold> ResourceThresholds;
+
+	// Pending timers for the next threshold each regenerating resource crosses
+	TMap<EResourceType, FTimerHandle> ThresholdTimerHandles;
+
+	UFUNCTION()
+	void OnRep_Attributes(const TArray<FResourceAttribute>& PreviousAttributes);
+
+	// Rebuild the attributes of a player this machine does not own from the quantized view
+	UFUNCTION()
+	void OnRep_SimulatedResources();
+
+	// Flag the attributes for the next replication pass, refreshing the non-owner view on the server
+	void MarkAttributesDirty();
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resources")
-	float CurrentHealth;
+	// Fire the change events for the resources in ChangedMask, then any thresholds they crossed
+	void BroadcastResourcesChanged(int32 ChangedMask, const FResourceAmounts& PreviousValues, const FResourceAmounts& PreviousMaxes);
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resources")
-	float MaxMana;
+	// Fold regeneration since the last update into the stored value
+	void SettleResource(EResourceType ResourceType);
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resources")
-	float CurrentMana;
+	void NotifyThresholdsCrossed(EResourceType ResourceType, float PreviousValue, float PreviousMax, float CurrentValue);
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resources")
-	float MaxStamina;
+	// Arm a timer for the next threshold regeneration will cross, replacing any pending one
+	void ScheduleThresholdTimer(EResourceType ResourceType);
+	void HandleThresholdTimer(EResourceType ResourceType);
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resources")
-	float CurrentStamina;
+	double GetWorldTime() const;
 
-	// Helper function to get resource reference
-	float* GetResourceRef(EResourceType ResourceType);
-	const float* GetResourceRef(EResourceType ResourceType) const;
-	float* GetMaxResourceRef(EResourceType ResourceType);
-	const float* GetMaxResourceRef(EResourceType ResourceType) const;
+	// Get a resource's stored state, or nullptr for an unknown type
+	FResourceAttribute* FindAttribute(EResourceType ResourceType);
+	const FResourceAttribute* FindAttribute(EResourceType ResourceType) const;
 };
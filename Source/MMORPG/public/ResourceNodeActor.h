@@ -7,8 +7,15 @@
 #include "ResourceTypes.h"
 #include "ResourceNodeActor.generated.h"
 
+class AResourceNodeActor;
+class UResourceNodeSubsystem;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnResourceNodeEvent, AResourceNodeActor*, Node);
+
 /**
  * Actor representing a resource node that can be gathered from
+ * Once play begins the node's live quantity is owned by UResourceNodeSubsystem; the actor holds the
+ * node's configuration and reads and gathers through the subsystem
  */
 UCLASS()
 class MMORPG_API AResourceNodeActor : public AActor
@@ -20,6 +27,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 	/**
@@ -29,10 +37,11 @@ public:
 	EResourceType ResourceType = EResourceType::Wood;
 
 	/**
-	 * The current quantity of resources available in this node
+	 * The quantity of resources the node starts with; read GetRemainingResources for the live value,
+	 * and change it with SetRemainingResources
 	 */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resource Node")
-	int32 CurrentQuantity = 100;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource Node")
+	int32 StartingQuantity = 100;
 
 	/**
 	 * The maximum quantity this node can hold
@@ -90,16 +99,34 @@ public:
 	 * @return The current quantity of resources
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource Node")
-	int32 GetRemainingResources() const { return CurrentQuantity; }
+	int32 GetRemainingResources() const;
 
-private:
 	/**
-	 * Handle for the regeneration timer
+	 * Set the remaining resources in this node, firing OnDepleted or OnRespawned if this empties or refills it
+	 * Outside of play this sets StartingQuantity
+	 * @param Quantity - The new quantity, clamped to MaxQuantity
 	 */
-	FTimerHandle RegenerationTimerHandle;
+	UFUNCTION(BlueprintCallable, Category = "Resource Node")
+	void SetRemainingResources(int32 Quantity);
 
 	/**
-	 * Regenerate resources
+	 * Fired when gathering empties the node, for hiding its mesh or playing effects
 	 */
-	void RegenerateResources();
+	UPROPERTY(BlueprintAssignable, Category = "Resource Node")
+	FOnResourceNodeEvent OnDepleted;
+
+	/**
+	 * Fired when an empty node regenerates its first resources
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Resource Node")
+	FOnResourceNodeEvent OnRespawned;
+
+private:
+	/**
+	 * Subsystem holding the node's state, and the node's index in it; unset outside of play
+	 */
+	UPROPERTY(Transient)
+	UResourceNodeSubsystem* NodeSubsystem = nullptr;
+
+	int32 NodeIndex = INDEX_NONE;
 };
@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatTimerWheel.h"
+#include "ResourceNodeActor.h"
+#include "ResourceNodeSubsystem.generated.h"
+
+/**
+ * Resource Node Subsystem
+ * Owns the live state of every resource node in the world in one pooled array; node actors register in
+ * BeginPlay and read and gather through it
+ * Regeneration is lazy: a node stores its quantity with the time its current regeneration interval started,
+ * and queries and gathers add the whole intervals that have passed since. Only depleted nodes that
+ * regenerate have a timer, in one timer wheel that fires their respawn events, so untouched nodes cost nothing
+ */
+UCLASS()
+class MMORPG_API UResourceNodeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Seconds per timer wheel tick; respawns fire up to this late */
+	static constexpr double TimerResolution = 0.25;
+
+	/**
+	 * Take over a node's state, starting from its configured quantity and regeneration settings
+	 * @return Index the node reads and gathers through until it unregisters
+	 */
+	int32 RegisterNode(AResourceNodeActor* Node);
+
+	/** Drop a node's state and any pending respawn */
+	void UnregisterNode(int32 NodeIndex);
+
+	/** Get a node's quantity including regeneration up to now; 0 for an unknown index */
+	int32 GetQuantity(int32 NodeIndex) const;
+
+	/**
+	 * Take up to an amount from a node, firing OnNodeDepleted if this empties it
+	 * @return The amount actually taken
+	 */
+	int32 Gather(int32 NodeIndex, int32 AmountToGather);
+
+	/** Set a node's quantity, clamped to its maximum, firing the depleted or respawn events if this empties or refills it */
+	void SetQuantity(int32 NodeIndex, int32 Quantity);
+
+	/** Get the number of registered nodes */
+	UFUNCTION(BlueprintCallable, Category = "Resource Nodes")
+	int32 GetNumNodes() const { return NumNodes; }
+
+	/** Get the number of depleted nodes waiting to respawn */
+	UFUNCTION(BlueprintCallable, Category = "Resource Nodes")
+	int32 GetNumPendingRespawns() const { return TimerWheel.Num(); }
+
+	/** Fired when a gather empties a node, before the node's own OnDepleted */
+	UPROPERTY(BlueprintAssignable, Category = "Resource Nodes")
+	FOnResourceNodeEvent OnNodeDepleted;
+
+	/** Fired when an empty node regenerates its first resources, before the node's own OnRespawned */
+	UPROPERTY(BlueprintAssignable, Category = "Resource Nodes")
+	FOnResourceNodeEvent OnNodeRespawned;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return TimerWheel.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FResourceNodeState
+	{
+		/** Null while the slot is free */
+		TWeakObjectPtr<AResourceNodeActor> Actor;
+
+		/** World time the interval now in progress started; only meaningful below MaxQuantity */
+		double RegenStartTime = 0.0;
+		float RegenerationInterval = 0.0f;
+
+		/** Quantity as of RegenStartTime */
+		int32 Quantity = 0;
+		int32 MaxQuantity = 0;
+
+		/** Gained per interval; 0 for nodes that do not regenerate */
+		int32 RegenerationAmount = 0;
+
+		FCombatTimerHandle RespawnTimer;
+		bool bDepleted = false;
+		bool bRegistered = false;
+	};
+
+	/** Quantity including the whole intervals regenerated by a time */
+	static int32 GetQuantityAt(const FResourceNodeState& Node, double Now);
+
+	/** Fold the intervals regenerated by now into the stored quantity, keeping the partial one */
+	static void SettleNode(FResourceNodeState& Node, double Now);
+
+	/** Arm the timer for when an empty node's next interval completes */
+	void ScheduleRespawn(int32 NodeIndex, double Now);
+
+	/** Clear a respawned node's depleted state and fire the respawn events */
+	void FinishRespawn(int32 NodeIndex);
+
+	double GetWorldTime() const;
+
+	/** Round seconds up to timer wheel ticks, so a respawn never fires before the node has regenerated */
+	static uint64 SecondsToTicks(double Seconds);
+
+	/** Pooled node slots */
+	TArray<FResourceNodeState> Nodes;
+	TArray<int32> FreeNodeIndices;
+	int32 NumNodes = 0;
+
+	FCombatTimerWheel TimerWheel;
+
+	/** Payloads fired this frame, reused between frames */
+	TArray<uint32> FiredTimers;
+};
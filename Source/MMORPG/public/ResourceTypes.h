@@ -19,6 +19,31 @@ enum class EResourceType : uint8
 	Crystal UMETA(DisplayName = "Crystal")
 };
 
+/** Number of EResourceType values, including None; keep in step with the enum */
+constexpr int32 NumResourceTypes = static_cast<int32>(EResourceType::Crystal) + 1;
+
+/**
+ * Fixed-size counter per resource type, indexed directly by EResourceType
+ */
+struct FResourceCounts
+{
+	int32 Counts[NumResourceTypes] = {};
+
+	int32& operator[](EResourceType ResourceType) { return Counts[static_cast<int32>(ResourceType)]; }
+	int32 operator[](EResourceType ResourceType) const { return Counts[static_cast<int32>(ResourceType)]; }
+
+	/** Number of types with a non-zero count */
+	int32 NumNonZero() const
+	{
+		int32 Result = 0;
+		for (int32 Count : Counts)
+		{
+			Result += Count != 0 ? 1 : 0;
+		}
+		return Result;
+	}
+};
+
 /**
  * Structure representing a resource item with type and quantity
  */
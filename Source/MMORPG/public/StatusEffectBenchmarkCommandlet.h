@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BenchmarkCommandlet.h"
+#include "CombatTimerWheel.h"
+#include "StatusEffectBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless status effect timing benchmark
+ * Keeps 100,000 effects active on the timer wheel status effects run on, each with an expiry and a
+ * one-second periodic tick, and measures 30 Hz frames, refreshes and apply/remove churn
+ * Also checks that an effect applied through UStatusEffectSubsystem after a minute with no effects lasts its full duration
+ * Run with: UnrealEditor-Cmd MMORPG.uproject -run=StatusEffectBenchmark -nullrhi [-iterations=N] [-seed=N] [-csv=Path]
+ */
+UCLASS()
+class MMORPG_API UStatusEffectBenchmarkCommandlet : public UBenchmarkCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void RunScenarios() override;
+	virtual FString GetDefaultCsvName() const override { return TEXT("StatusEffectBenchmark.csv"); }
+
+private:
+	/** Timers of one simulated effect */
+	struct FBenchmarkEffect
+	{
+		FCombatTimerHandle ExpiryTimer;
+		FCombatTimerHandle PeriodTimer;
+	};
+
+	/** Apply an effect in a real world after an idle spell and check it is not cut short */
+	void RunApplyAfterIdle();
+
+	/** Give an effect a fresh random duration and restart its periodic tick */
+	void StartEffect(int32 EffectIndex);
+
+	/** Cancel both of an effect's timers */
+	void StopEffect(int32 EffectIndex);
+
+	FCombatTimerWheel TimerWheel;
+	TArray<FBenchmarkEffect> Effects;
+	TArray<uint32> FiredTimers;
+};
@@ -0,0 +1,190 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatTypes.h"
+#include "CombatTimerWheel.h"
+#include "StatusEffectSubsystem.generated.h"
+
+class UCombatComponent;
+
+/**
+ * What happens when an effect is applied to a target that already has it
+ */
+UENUM(BlueprintType)
+enum class EStatusEffectStacking : uint8
+{
+	Refresh         UMETA(DisplayName = "Refresh Duration"),
+	Stack           UMETA(DisplayName = "Add Stack"),
+	Independent     UMETA(DisplayName = "Independent"),
+	Ignore          UMETA(DisplayName = "Ignore")
+};
+
+/**
+ * A buff, debuff or damage-over-time effect
+ */
+USTRUCT(BlueprintType)
+struct FStatusEffectDefinition
+{
+	GENERATED_BODY()
+
+	// Seconds the effect lasts; 0 or less lasts until removed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status Effect")
+	float Duration = 10.0f;
+
+	// Seconds between periodic ticks; 0 or less never ticks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status Effect")
+	float TickInterval = 1.0f;
+
+	// Resource changed on each tick
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status Effect")
+	EResourceType ResourceType = EResourceType::Health;
+
+	// Change per tick and stack; negative health goes through the target's damage mitigation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status Effect")
+	float ResourceDeltaPerTick = 0.0f;
+
+	// Added to the target's damage mitigation per stack while active; negative makes it take more damage
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status Effect")
+	float DamageMitigationPerStack = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status Effect")
+	EStatusEffectStacking Stacking = EStatusEffectStacking::Refresh;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status Effect", meta = (ClampMin = "1"))
+	int32 MaxStacks = 1;
+};
+
+/**
+ * Identifies one active effect; stale once the effect ends
+ */
+USTRUCT(BlueprintType)
+struct FStatusEffectHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Index = INDEX_NONE;
+
+	UPROPERTY()
+	int32 Generation = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnStatusEffectChanged, UCombatComponent*, Target, FName, EffectName, int32, Stacks);
+
+/**
+ * Status Effect Subsystem
+ * Runs every buff, debuff and damage-over-time effect in the world from one timer wheel
+ * Expiries and periodic ticks are timers in the wheel, so applying and removing effects is O(1) and
+ * each frame handles only the timers that came due, in one batch; no effect has its own tick or FTimerHandle
+ * Periodic drains of any resource go through the combat damage queue, restores through UResourceComponent
+ */
+UCLASS()
+class MMORPG_API UStatusEffectSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Seconds per timer wheel tick; effect timings are rounded to this */
+	static constexpr double TimerResolution = 0.05;
+
+	/** Register an effect under a name, replacing any existing definition */
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	void RegisterEffect(FName EffectName, const FStatusEffectDefinition& Definition);
+
+	/**
+	 * Apply a registered effect, following its stacking rule if the target already has it
+	 * @return The effect now running on the target; invalid if the effect is not registered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	FStatusEffectHandle ApplyEffect(UCombatComponent* Target, FName EffectName, AActor* EffectInstigator);
+
+	/** End an effect early. Returns whether it was still active */
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	bool RemoveEffect(FStatusEffectHandle Handle);
+
+	/** End every effect on a target */
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	void RemoveAllEffects(UCombatComponent* Target);
+
+	/** Get the stacks of an effect on a target, summed over independent instances; 0 if it has none */
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	int32 GetEffectStacks(const UCombatComponent* Target, FName EffectName) const;
+
+	/** Get the number of active effects in the world */
+	UFUNCTION(BlueprintCallable, Category = "Status Effects")
+	int32 GetNumActiveEffects() const { return NumActiveEffects; }
+
+	/** Fired when an effect is applied, changes stacks or ends; Stacks is 0 when it ends */
+	UPROPERTY(BlueprintAssignable, Category = "Status Effects")
+	FOnStatusEffectChanged OnStatusEffectChanged;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return NumActiveEffects > 0; }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FActiveStatusEffect
+	{
+		TWeakObjectPtr<UCombatComponent> Target;
+
+		/** Key of the target's list in FirstEffectByTarget; never dereferenced */
+		const UCombatComponent* TargetKey = nullptr;
+		TWeakObjectPtr<AActor> Instigator;
+		FCombatTimerHandle ExpiryTimer;
+		FCombatTimerHandle PeriodTimer;
+
+		/** Index into Definitions, or INDEX_NONE while the slot is free */
+		int32 Definition = INDEX_NONE;
+		int32 Stacks = 0;
+		int32 Generation = 0;
+
+		/** Neighbours in the target's effect list; doubles as the free list link */
+		int32 PrevOnTarget = INDEX_NONE;
+		int32 NextOnTarget = INDEX_NONE;
+	};
+
+	/** Bring an empty timer wheel up to the world's current tick before scheduling into it */
+	void CatchUpIdleTimerWheel();
+
+	int32 AllocateEffect();
+	void EndEffect(int32 EffectIndex);
+	void RestartExpiry(FActiveStatusEffect& Effect, int32 EffectIndex);
+	void ApplyPeriodicTick(int32 EffectIndex);
+	void SetStacks(int32 EffectIndex, int32 NewStacks);
+	FStatusEffectHandle MakeHandle(int32 EffectIndex) const;
+
+	/** Round seconds to timer wheel ticks */
+	static uint64 SecondsToTicks(float Seconds);
+
+	/** Timer payloads carry the effect index and whether it is the periodic timer */
+	static uint32 MakePayload(int32 EffectIndex, bool bPeriodic) { return (static_cast<uint32>(EffectIndex) << 1) | (bPeriodic ? 1u : 0u); }
+
+	TArray<FStatusEffectDefinition> Definitions;
+	TArray<FName> DefinitionNames;
+	TMap<FName, int32> DefinitionIndexByName;
+
+	/** Pooled effect slots */
+	TArray<FActiveStatusEffect> Effects;
+	int32 FirstFreeEffect = INDEX_NONE;
+	int32 NumActiveEffects = 0;
+
+	/** Head of each target's effect list */
+	TMap<const UCombatComponent*, int32> FirstEffectByTarget;
+
+	FCombatTimerWheel TimerWheel;
+
+	/** Payloads fired this frame, reused between frames */
+	TArray<uint32> FiredTimers;
+
+	/** While a frame's timers are handled, freed slots wait here so stale payloads can't reach a reused slot */
+	TArray<int32> DeferredFreeEffects;
+	bool bHandlingTimers = false;
+};
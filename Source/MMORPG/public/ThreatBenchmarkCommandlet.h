@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BenchmarkCommandlet.h"
+#include "ThreatBenchmarkCommandlet.generated.h"
+
+class ACombatCharacter;
+class UCombatComponent;
+class UThreatComponent;
+
+/**
+ * Headless threat table benchmark
+ * Spawns one boss with a threat component and 200 attackers around it, then fights at 30 Hz: attackers hit
+ * the boss through the damage queue, the boss cleaves a few of them and healers heal the wounded
+ * Each frame checks the boss's cached top target against a scan of every attacker's threat
+ * Run with: UnrealEditor-Cmd MMORPG.uproject -run=ThreatBenchmark -nullrhi [-attackers=N] [-frames=N] [-iterations=N] [-seed=N] [-csv=Path]
+ */
+UCLASS()
+class MMORPG_API UThreatBenchmarkCommandlet : public UBenchmarkCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void ParseParams(const FString& Params) override;
+	virtual void RunScenarios() override;
+	virtual FString GetDefaultCsvName() const override { return TEXT("ThreatBenchmark.csv"); }
+
+private:
+	/** One attacker and its cached combat component */
+	struct FBenchmarkAttacker
+	{
+		ACombatCharacter* Character = nullptr;
+		UCombatComponent* Combat = nullptr;
+	};
+
+	/** Spawn the boss with a threat component, deferring BeginPlay so the combat registry finds it */
+	ACombatCharacter* SpawnBoss(UWorld* World);
+
+	/** Check the cached top target against the highest threat of any attacker */
+	bool IsTopThreatCorrect() const;
+
+	int32 NumAttackers = 200;
+	int32 NumFrames = 600;
+
+	ACombatCharacter* Boss = nullptr;
+	UCombatComponent* BossCombat = nullptr;
+	UThreatComponent* BossThreat = nullptr;
+	TArray<FBenchmarkAttacker> Attackers;
+};
@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ThreatTable.h"
+#include "ThreatComponent.generated.h"
+
+class UCombatRegistry;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTopThreatChanged, AActor*, NewTopThreat);
+
+/**
+ * Threat table for an NPC combatant
+ * Fed by the combat pipeline: damage taken adds threat for the attacker, and healing anyone on
+ * this table adds threat for the healer. Threat decays over time without ticking
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class MMORPG_API UThreatComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UThreatComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Add threat for an actor, or reduce it with a negative amount
+	UFUNCTION(BlueprintCallable, Category = "Threat")
+	void AddThreat(AActor* ThreatActor, float Amount);
+
+	// Add threat for damage taken from an attacker
+	void AddDamageThreat(AActor* Attacker, float Damage);
+
+	// Add threat for healing done to an actor on this table
+	void AddHealThreat(AActor* Healer, float Healing);
+
+	// Drop an actor from the table
+	UFUNCTION(BlueprintCallable, Category = "Threat")
+	void RemoveThreatTarget(const AActor* ThreatActor);
+
+	// Forget every attacker
+	UFUNCTION(BlueprintCallable, Category = "Threat")
+	void ClearThreat();
+
+	// Get the actor with the most threat, or null if nobody has any
+	UFUNCTION(BlueprintCallable, Category = "Threat")
+	AActor* GetHighestThreatTarget();
+
+	// Get an actor's current threat
+	UFUNCTION(BlueprintCallable, Category = "Threat")
+	float GetThreat(const AActor* ThreatActor) const;
+
+	// Check whether an actor is on the table
+	UFUNCTION(BlueprintCallable, Category = "Threat")
+	bool HasThreat(const AActor* ThreatActor) const { return Table.Contains(ThreatActor); }
+
+	// Get the number of actors on the table; at most FThreatTable::Capacity
+	UFUNCTION(BlueprintCallable, Category = "Threat")
+	int32 GetNumThreatTargets() const { return Table.Num(); }
+
+	// Fired when the highest threat target changes; null when the table empties
+	UPROPERTY(BlueprintAssignable, Category = "Threat")
+	FOnTopThreatChanged OnTopThreatChanged;
+
+protected:
+	// Seconds for threat to halve; 0 never decays. Read in BeginPlay
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Threat", meta = (ClampMin = "0.0"))
+	float ThreatHalfLife = 30.0f;
+
+	// Threat per point of damage taken
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threat", meta = (ClampMin = "0.0"))
+	float DamageThreatMultiplier = 1.0f;
+
+	// Threat per point of healing done to someone on the table
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Threat", meta = (ClampMin = "0.0"))
+	float HealThreatMultiplier = 0.5f;
+
+	// Registry told when this table starts and stops holding threat
+	UPROPERTY()
+	UCombatRegistry* CombatRegistry = nullptr;
+
+private:
+	// Fire OnTopThreatChanged and keep the registry's engaged list in step with the table
+	void HandleTableChanged(bool bTopChanged);
+
+	double GetWorldTime() const;
+
+	FThreatTable Table;
+	bool bEngaged = false;
+};
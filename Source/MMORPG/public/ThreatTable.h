@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * One attacker's standing in a threat table
+ */
+struct FThreatEntry
+{
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Threat scaled up by the decay since the table's base time; only comparable within one table */
+	float ScaledThreat = 0.0f;
+};
+
+/**
+ * Fixed-capacity threat table with exponential decay and a cached top entry
+ * Every entry decays at the same rate, so decay never reorders entries: values are stored scaled by
+ * the decay since a base time and only converted on read, and nothing is updated per frame
+ * The top entry is kept up to date on every increase and found again only when it drops or leaves,
+ * so asking for the highest threat is O(1) amortized
+ * Entries live inline; when the table is full the lowest entry makes way for a larger one, which
+ * never changes the top target
+ */
+class MMORPG_API FThreatTable
+{
+public:
+	static constexpr int32 Capacity = 64;
+
+	/** Set how many seconds threat takes to halve; 0 or less never decays. Meant to be set while the table is empty */
+	void SetHalfLife(float HalfLifeSeconds);
+
+	/**
+	 * Add threat for an actor, or take it away with a negative amount
+	 * An actor whose threat is taken down to nearly nothing leaves the table
+	 * @return Whether the top actor changed
+	 */
+	bool AddThreat(AActor* Actor, float Amount, double Now);
+
+	/** Drop an actor from the table. Returns whether the top actor changed */
+	bool RemoveActor(const AActor* Actor);
+
+	/** Get the actor with the most threat, or nullptr if the table is empty */
+	AActor* GetTopActor();
+
+	/** Get an actor's current threat; 0 if it is not in the table */
+	float GetThreat(const AActor* Actor, double Now) const;
+
+	bool Contains(const AActor* Actor) const { return FindIndex(Actor) != INDEX_NONE; }
+	int32 Num() const { return Entries.Num(); }
+	void Reset();
+
+private:
+	int32 FindIndex(const AActor* Actor) const;
+	int32 FindLowestIndex() const;
+	void RemoveAt(int32 Index);
+
+	/** Find the top entry again by scanning, dropping entries whose actor is gone */
+	void RefreshTop();
+
+	/** Convert between current and stored threat, rebasing first if the scale factor has grown large */
+	float ToScaled(float Threat, double Now);
+	float FromScaled(float ScaledThreat, double Now) const;
+	void Rebase(double Now);
+
+	TArray<FThreatEntry, TFixedAllocator<Capacity>> Entries;
+	int32 TopIndex = INDEX_NONE;
+
+	/** Decay per second as a natural exponent, and the time stored values are relative to */
+	float DecayRate = 0.0f;
+	double BaseTime = 0.0;
+};
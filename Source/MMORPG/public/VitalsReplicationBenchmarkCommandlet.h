@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BenchmarkCommandlet.h"
+#include "ResourceComponent.h"
+#include "VitalsReplicationBenchmarkCommandlet.generated.h"
+
+class UPlayerAttributesComponent;
+
+/**
+ * Headless bandwidth estimate for player vitals in a large fight
+ * Drives 200 real player attribute components through hits, heals, resource costs and buffs at 30 Hz, and
+ * counts the bits each net update would send from their replicated state: every value at full precision to
+ * every connection, as before push-model replication, against full precision to the owner and 10-bit fill
+ * levels, maximums and rates to everyone else. This is a modeled estimate: framing follows the rep layout,
+ * and packet and bunch headers are left out, since they are shared with everything else in the packet
+ * Run with: UnrealEditor-Cmd MMORPG.uproject -run=VitalsReplicationBenchmark -nullrhi [-players=N] [-seconds=N] [-iterations=N] [-seed=N] [-csv=Path]
+ */
+UCLASS()
+class MMORPG_API UVitalsReplicationBenchmarkCommandlet : public UBenchmarkCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void ParseParams(const FString& Params) override;
+	virtual void RunScenarios() override;
+	virtual FString GetDefaultCsvName() const override { return TEXT("VitalsReplicationBenchmark.csv"); }
+
+private:
+	/** A player's attributes on the server, and the shadow state of what receivers were last sent */
+	struct FBenchmarkPlayer
+	{
+		UPlayerAttributesComponent* Attributes = nullptr;
+
+		TArray<FResourceAttribute> SentAttributes;
+		float SentXP = 0.0f;
+		FQuantizedResourceFractions SentFractions;
+		TArray<FSimulatedResource> SentSimulated;
+
+		/** Set by every change, as the component marks its properties dirty */
+		bool bDirty = false;
+
+		/** Whether the buff that raises the player's regeneration is up */
+		bool bBuffed = false;
+	};
+
+	/** Spawn an actor carrying a player attribute component, deferring BeginPlay until its maximums are set */
+	UPlayerAttributesComponent* SpawnPlayer(UWorld* World);
+
+	/** Refill a dead player and credit the kill to someone else */
+	void Respawn(int32 PlayerIndex);
+
+	/** Take the replicated state as sent, as if a net update just went out */
+	static void MarkSent(FBenchmarkPlayer& Player);
+
+	/** Bits of an attribute array update carrying the fields that differ from the shadow state; 0 if none */
+	static int32 GetAttributeUpdateBits(const FBenchmarkPlayer& Player);
+
+	/** Bits of a maximum and rate array update carrying the fields that differ from the shadow state; 0 if none */
+	static int32 GetSimulatedUpdateBits(const FBenchmarkPlayer& Player);
+
+	/** Bits NetSerialize writes for the quantized fill levels, measured with a bit writer */
+	static int32 MeasureQuantizedBits(int32& OutRoundTripErrors);
+
+	int32 NumPlayers = 200;
+	int32 NumSeconds = 60;
+
+	TArray<FBenchmarkPlayer> Players;
+};